@@ -2,9 +2,36 @@
 
 #include "ArtilleryEditorModule.h"
 #include "UArtilleryAbilityMinimum.h"
+#include "FGunDefinitionBlob.h"
 
 #define LOCTEXT_NAMESPACE "FArtilleryEditorModule"
 
+//the gun data build step. reads the gun definitions table and writes the blob the runtime maps.
+//it writes to the pending path, so a running pie session picks it up within a second or so.
+static FAutoConsoleCommand CompileGunDefinitionsCommand(
+	TEXT("Artillery.CompileGunDefinitions"),
+	TEXT("Compiles the gun definitions table into the binary gun data blob."),
+	FConsoleCommandDelegate::CreateLambda([]()
+	{
+		UDataTable* Table = TSoftObjectPtr<UDataTable>(FSoftObjectPath(TEXT("/Game/DataTables/GunDefinitions.GunDefinitions"))).LoadSynchronous();
+		if (!Table)
+		{
+			UE_LOG(LogTemp, Error, TEXT("Artillery: no gun definitions table to compile."));
+			return;
+		}
+		TArray<const FGunDefinitionRow*> Rows;
+		Table->GetAllRows<FGunDefinitionRow>(TEXT("CompileGunDefinitions"), Rows);
+		const FString Out = FGunDefinitionBlob::PendingPath(FGunDefinitionBlob::DefaultPath());
+		if (FGunDefinitionBlob::Compile(Rows, Out))
+		{
+			UE_LOG(LogTemp, Log, TEXT("Artillery: compiled %d gun definitions to %s."), Rows.Num(), *Out);
+		}
+		else
+		{
+			UE_LOG(LogTemp, Error, TEXT("Artillery: couldn't write %s."), *Out);
+		}
+	}));
+
 void FArtilleryEditorModule::StartupModule()
 {
 	// This code will execute after your module is loaded into memory;
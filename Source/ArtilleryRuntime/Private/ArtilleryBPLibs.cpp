@@ -0,0 +1,8 @@
+#include "ArtilleryBPLibs.h"
+
+static thread_local FArtilleryInputBatch EstimatorInputs;
+
+FArtilleryInputBatch& UArtilleryLibrary::EstimatorScratch()
+{
+	return EstimatorInputs;
+}
@@ -2,38 +2,66 @@
 
 
 #include "ArtilleryDispatch.h"
+#include "FArtilleryWorkerPool.h"
 #include "FArtilleryGun.h"
+#include "FGunDefinitionRow.h"
 #include <FTEntityFinalTickResolver.h>
 #include <FTGunFinalTickResolver.h>
 #include <FTJumpTimer.h>
 
 #include "FTProjectileFinalTickResolver.h"
+#include "ArtilleryProjectileDispatch.h"
+
+//the pump's element type isn't named anywhere we can see, so pull it off the queue.
+template <typename Queue>
+struct TTransformPumpElement;
+template <typename Element>
+struct TTransformPumpElement<TCircularQueue<Element>>
+{
+	typedef Element Type;
+};
 
 
+//see TL_ThreadedImpl. file scope rather than a static member, since a thread_local member of an exported class
+//won't compile on msvc.
+static thread_local UArtilleryDispatch::FTicklitesWorker* TicklitesWorkerOnThisThread = nullptr;
+
+UArtilleryDispatch::FTicklitesWorker* UArtilleryDispatch::TL_ThreadedImpl::ADispatch()
+{
+	return TicklitesWorkerOnThisThread;
+}
+
+void UArtilleryDispatch::TL_ThreadedImpl::SetADispatch(FTicklitesWorker* Worker)
+{
+	TicklitesWorkerOnThisThread = Worker;
+}
+
 //Place at the end of the latest initialization-like phase.
 //should we move this lil guy over into ya boy Dispatch? It feels real dispatchy.
 void UArtilleryDispatch::REGISTER_ENTITY_FINAL_TICK_RESOLVER(ActorKey Self)
 {
 	TLEntityFinalTickResolver temp = TLEntityFinalTickResolver(Self); //this semantic sucks. gotta fix it.
-	this->RequestAddTicklite(MakeShareable(new EntityFinalTickResolver(temp)), FINAL_TICK_RESOLVE);
+	this->RequestAddTicklite(MakeShareable(new EntityFinalTickResolver(temp)), FINAL_TICK_RESOLVE, Self);
+	//entities are what targeting and area effects look for.
+	RegisterForProximityQueries(Self);
 }
 
 void UArtilleryDispatch::REGISTER_PROJECTILE_FINAL_TICK_RESOLVER(uint32 MaximumLifespanInTicks, FSkeletonKey Self)
 {
 	TLProjectileFinalTickResolver temp = TLProjectileFinalTickResolver(MaximumLifespanInTicks, Self);
-	this->RequestAddTicklite(MakeShareable(new ProjectileFinalTickResolver(temp)), FINAL_TICK_RESOLVE);
+	this->RequestAddTicklite(MakeShareable(new ProjectileFinalTickResolver(temp)), FINAL_TICK_RESOLVE, Self);
 }
 
 void UArtilleryDispatch::REGISTER_GUN_FINAL_TICK_RESOLVER(FGunKey Self)
 {
 	TLGunFinalTickResolver temp = TLGunFinalTickResolver(Self); //this semantic sucks. gotta fix it.
-	this->RequestAddTicklite(MakeShareable(new GunFinalTickResolver(temp)), FINAL_TICK_RESOLVE);
+	this->RequestAddTicklite(MakeShareable(new GunFinalTickResolver(temp)), FINAL_TICK_RESOLVE, Self);
 }
 
 void UArtilleryDispatch::INITIATE_JUMP_TIMER(FSkeletonKey Self)
 {
 	FTJumpTimer JumpTimer = FTJumpTimer(Self);
-	this->RequestAddTicklite(MakeShareable(new TL_JumpTimer(JumpTimer)), Normal);
+	this->RequestAddTicklite(MakeShareable(new TL_JumpTimer(JumpTimer)), Normal, Self);
 }
 
 void UArtilleryDispatch::Initialize(FSubsystemCollectionBase& Collection)
@@ -43,12 +71,14 @@ void UArtilleryDispatch::Initialize(FSubsystemCollectionBase& Collection)
 	RequestorQueue_Abilities_TripleBuffer = MakeShareable( new TTripleBuffer<TArray<TPair<BristleTime,FGunKey>>>());
 	RequestorQueue_Locomos_TripleBuffer = MakeShareable( new TTripleBuffer<TArray<LocomotionParams>>());
 	GunToFiringFunctionMapping = MakeShareable(new TMap<FGunKey, FArtilleryFireGunFromDispatch>());
+	GunToCueFunctionMapping = MakeShareable(new TMap<FGunKey, FArtilleryCueGunFromDispatch>());
+	FireCues = MakeShareable(new FireCueQueue(1024));
+	TransformSnapshots = MakeShareable(new FTransformSnapshotBuffer(16384));
 	ActorToLocomotionMapping = MakeShareable(new TMap<ActorKey, FArtilleryRunLocomotionFromDispatch>());
 	AttributeSetToDataMapping = MakeShareable( new TMap<FSkeletonKey, AttrMapPtr>());
 	IdentSetToDataMapping = MakeShareable(new TMap<FSkeletonKey, IdMapPtr>());
+	PublishedSimState = MakeShareable(new FPublishedSimState());
 	GunByKey = MakeShareable(new TMap<FGunKey, TSharedPtr<FArtilleryGun>>());
-	TL_ThreadedImpl::ADispatch = &ArtilleryTicklitesWorker_LockstepToWorldSim;
-	SelfPtr = this;
 }
 
 void UArtilleryDispatch::PostInitialize()
@@ -56,6 +86,8 @@ void UArtilleryDispatch::PostInitialize()
 	Super::PostInitialize();
 	UBarrageDispatch* PhysicsECS = GetWorld()->GetSubsystem<UBarrageDispatch>();
 	TransformUpdateQueue = PhysicsECS->GameTransformPump;
+	PassthroughTransforms = MakeShareable(new TransformUpdatesForGameThread(8192));
+	ForwardedTransforms = MakeShareable(new TransformUpdatesForGameThread(16384));
 	
 	UCanonicalInputStreamECS* InputECS = GetWorld()->GetSubsystem<UCanonicalInputStreamECS>();
 	ArtilleryAsyncWorldSim.CablingControlStream = InputECS->getNewStreamConstruct(APlayer::CABLE);
@@ -67,16 +99,35 @@ void UArtilleryDispatch::OnWorldBeginPlay(UWorld& InWorld)
 	
 	if ([[maybe_unused]] const UWorld* World = InWorld.GetWorld()) {
 		UE_LOG(LogTemp, Warning, TEXT("ArtilleryDispatch:Subsystem: World beginning play"));
+		//the loadout lives in the gun definitions. anything with a prewarm count gets its pool built now, at load.
+		if (LoadGunData())
+		{
+			PrewarmFromGunData();
+		}
+#if !UE_BUILD_SHIPPING
+		else
+		{
+			UE_LOG(LogTemp, Warning, TEXT("ArtilleryDispatch: no compiled gun data, reading the table. Run Artillery.CompileGunDefinitions."));
+			GunDefinitionsManifest = TSoftObjectPtr<UDataTable>(FSoftObjectPath(TEXT("/Game/DataTables/GunDefinitions.GunDefinitions"))).LoadSynchronous();
+			if (GunDefinitionsManifest)
+			{
+				GunDefinitionsManifest->ForeachRow<FGunDefinitionRow>(TEXT("GunPrewarm"),
+					[this](const FName& RowName, const FGunDefinitionRow& Row)
+					{
+						if (Row.PrewarmCount > 0)
+						{
+							PrewarmGuns(Row.GunDefinitionId, Row.PrewarmCount);
+						}
+					});
+			}
+		}
+#endif
 		// getting input from Bristle
 		UseNetworkInput.store(true);
 		UBristleconeWorldSubsystem* NetworkAndControls = GetWorld()->GetSubsystem<UBristleconeWorldSubsystem>();
 		UBarrageDispatch* GameSimPhysics = GetWorld()->GetSubsystem<UBarrageDispatch>();
 		HoldOpen = GameSimPhysics->JoltGameSim;
 		ArtilleryTicklitesWorker_LockstepToWorldSim.DispatchOwner = this;
-		ArtilleryTicklitesWorker_LockstepToWorldSim.StartTicklitesApply = StartTicklitesApply;
-		ArtilleryTicklitesWorker_LockstepToWorldSim.StartTicklitesSim = StartTicklitesSim;
-		ArtilleryAsyncWorldSim.StartTicklitesApply = StartTicklitesApply;
-		ArtilleryAsyncWorldSim.StartTicklitesSim = StartTicklitesSim;
 		ArtilleryAsyncWorldSim.InputRingBuffer = MakeShareable(new PacketQ(256));
 		NetworkAndControls->QueueOfReceived = ArtilleryAsyncWorldSim.InputRingBuffer;
 		UCablingWorldSubsystem* DirectLocalInputSystem = GetWorld()->GetSubsystem<UCablingWorldSubsystem>();
@@ -91,9 +142,12 @@ void UArtilleryDispatch::OnWorldBeginPlay(UWorld& InWorld)
 		ArtilleryAsyncWorldSim.RequestorQueue_Locomos_TripleBuffer = RequestorQueue_Locomos_TripleBuffer;
 		UBarrageDispatch* PhysicsECS = GetWorld()->GetSubsystem<UBarrageDispatch>();
 		PhysicsECS->GrantFeed();
+		TransformECSPillarCache = GetWorld()->GetSubsystem<UTransformDispatch>();
+		PhysicsECSPillarCache = PhysicsECS;
 		
-		WorldSim_Thread.Reset(FRunnableThread::Create(&ArtilleryAsyncWorldSim, TEXT("ARTILLERY_ONLINE.")));
-		WorldSim_Ticklites_Thread.Reset(FRunnableThread::Create(&ArtilleryTicklitesWorker_LockstepToWorldSim ,TEXT("BARRAGE_ONLINE.")));
+		//no threads of our own. the pool starts us, and our ticklites, on whichever lane gets to us first, and its lanes
+		//take turns pumping us from there.
+		FArtilleryWorkerPool::Get().Host(&ArtilleryAsyncWorldSim);
 
 
 	}
@@ -104,27 +158,36 @@ void UArtilleryDispatch::Deinitialize()
 {
 
 	Super::Deinitialize();
-	StartTicklitesSim->Trigger();
-	ArtilleryTicklitesWorker_LockstepToWorldSim.running = false;
 	ArtilleryAsyncWorldSim.Stop();
-	StartTicklitesApply->Trigger();
-	ArtilleryTicklitesWorker_LockstepToWorldSim.Stop();
-	//We have to wait on worldsim, but we actually can just hard kill ticklites.
-	if(WorldSim_Thread.IsValid())
-	{
-		//if we don't wait, this will crash when the truth of the matter is referenced. That's just the facts.
-		WorldSim_Thread->Kill(true);
-	}
-	if(WorldSim_Ticklites_Thread.IsValid())
-	{
-		//otoh, we need to hard kill the ticklites, so far as I can tell, and keep rolling. This should actually generally
-		//not proc.
-		WorldSim_Ticklites_Thread->Kill(false);
-	}
+	//if we don't wait, this will crash when the truth of the matter is referenced. That's just the facts.
+	//release waits out whichever lane has us mid-pass, and ticklites only run inside one, so that covers both.
+	FArtilleryWorkerPool::Get().Release(&ArtilleryAsyncWorldSim);
 	AttributeSetToDataMapping->Empty();
 	IdentSetToDataMapping->Empty();
+	AttributeWatchers.Empty();
 	GunToFiringFunctionMapping->Empty();
 	ActorToLocomotionMapping->Empty();
+	//guns first, then the shared abilities. their binders point at us, not at any gun, but nothing should reach a gun
+	//through them once the abilities can be collected.
+	PooledGuns.Empty();
+	GunByKey->Empty();
+	SimGunByKey.Empty();
+	GunByKeyChanges.Empty();
+	SimAttributeSetToDataMapping.Empty();
+	AttributeSetChanges.Empty();
+	TransformECSPillarCache = nullptr;
+	PhysicsECSPillarCache = nullptr;
+	for (const TPair<uint32, FArtilleryAbilitySet>& Set : SharedAbilitySets)
+	{
+		Set.Value.ForEach([](UArtilleryPerActorAbilityMinimum* Phase)
+		{
+			Phase->GunBinder.Unbind();
+			Phase->RemoveFromRoot();
+		});
+	}
+	SharedAbilitySets.Empty();
+	AttributeTemplates.Empty();
+	DefinitionKeyParts.Empty();
 	HoldOpen.Reset();
 }
 
@@ -147,7 +210,31 @@ IdMapPtr UArtilleryDispatch::GetIdSetShadowByObjectKey(FSkeletonKey Target,
 void UArtilleryDispatch::Tick(float DeltaTime)
 {
 	Super::Tick(DeltaTime);
+	//first thing, so everything the game thread does this frame reads the same sim tick.
+	if (PublishedSimState->Latch())
+	{
+		DispatchAttributeChanges();
+	}
 	RunGuns(); // ALL THIS WORK. FOR THIS?! (Okay, that's really cool)
+	const uint64 Diverged = EarliestInputDivergence.exchange(MAX_uint64, std::memory_order_relaxed);
+	if (Diverged != MAX_uint64)
+	{
+		BindToInputDiverged.Broadcast(Diverged);
+	}
+#if !UE_BUILD_SHIPPING
+	//hot reload for the gun data. the compiler drops a .pending next to the blob and we pick it up here.
+	//the blob is shared by every world, so whichever world looks first reloads it for all of them. the pools are built
+	//at begin play, so a reload shows up in the next world to start.
+	SinceGunDataCheck += DeltaTime;
+	if (SinceGunDataCheck > 1.0f)
+	{
+		SinceGunDataCheck = 0;
+		if (FGunDefinitionBlob::Get().SwapInPending(FGunDefinitionBlob::DefaultPath()))
+		{
+			UE_LOG(LogTemp, Log, TEXT("ArtilleryDispatch: reloaded gun data."));
+		}
+	}
+#endif
 
 	auto PhysicsECSPillar = GetWorld()->GetSubsystem<UBarrageDispatch>();
 	if(PhysicsECSPillar)
@@ -158,11 +245,198 @@ void UArtilleryDispatch::Tick(float DeltaTime)
 			//because we are on the game thread, we can get away without full hold opens for now.
 			//I still want to refactor this into the threads somehow, but I just don't see a way right now
 			//since this calls gt-locked functions on actors in a lot of places.
-			TransformECSPillar->ApplyTransformUpdates
-			<TSharedPtr<TransformUpdatesForGameThread>>
-			(PhysicsECSPillar->GameTransformPump);
+			ApplyTransformUpdatesBatched(TransformECSPillar);
 		}
-		PhysicsECSPillar->BroadcastContactEvents();
+	}
+	//projectiles are spawned and hit on the busy worker now. all that's left for us is their meshes.
+	if (UArtilleryProjectileDispatch* ProjectileDispatch = GetWorld()->GetSubsystem<UArtilleryProjectileDispatch>())
+	{
+		ProjectileDispatch->FinishSimSpawns();
+		ProjectileDispatch->DeleteContactedProjectiles();
+	}
+}
+
+void UArtilleryDispatch::WatchAttribute(FSkeletonKey Owner, E_AttribKey Attrib, const FArtilleryAttributeChanged& OnChanged)
+{
+	TArray<FArtilleryAttributeChanged>& Watchers = AttributeWatchers.FindOrAdd({Owner, Attrib});
+	if (Watchers.IsEmpty())
+	{
+		PublishedSimState->Watch(Owner, Attrib);
+		Watchers.Add(OnChanged);
+		return;
+	}
+	if (Watchers.Contains(OnChanged))
+	{
+		return;
+	}
+	Watchers.Add(OnChanged);
+	//the sim only sends the current value for the first watch of a pair, and that may be long gone. hand this one the
+	//latched value now. if there isn't one yet, the sim's first send hasn't landed, and it goes to every watcher anyway.
+	float Latched;
+	if (PublishedSimState->GetAttribute(Owner, Attrib, Latched))
+	{
+		OnChanged.ExecuteIfBound(Owner, Attrib, Latched);
+	}
+}
+
+void UArtilleryDispatch::UnwatchAttribute(FSkeletonKey Owner, E_AttribKey Attrib, const FArtilleryAttributeChanged& OnChanged)
+{
+	TArray<FArtilleryAttributeChanged>* Watchers = AttributeWatchers.Find({Owner, Attrib});
+	if (!Watchers)
+	{
+		return;
+	}
+	Watchers->Remove(OnChanged);
+	if (Watchers->IsEmpty())
+	{
+		AttributeWatchers.Remove({Owner, Attrib});
+		PublishedSimState->Unwatch(Owner, Attrib);
+	}
+}
+
+//several sim ticks can land between two frames. only the newest value for each pair is worth telling anyone about.
+void UArtilleryDispatch::DispatchAttributeChanges()
+{
+	TMap<TPair<FSkeletonKey, E_AttribKey>, float, TInlineSetAllocator<64>> Newest;
+	PublishedSimState->DrainChanges([&Newest](const FPublishedSimState::FAttributeChange& Change)
+	{
+		Newest.Add({Change.Key, Change.Attrib}, Change.Value);
+	});
+	for (const TPair<TPair<FSkeletonKey, E_AttribKey>, float>& Change : Newest)
+	{
+		TArray<FArtilleryAttributeChanged>* Watchers = AttributeWatchers.Find(Change.Key);
+		if (!Watchers)
+		{
+			continue; // unwatched after the sim sent it.
+		}
+		//a watcher can unwatch from inside its own callback, so walk a copy and drop the dead ones after.
+		const TArray<FArtilleryAttributeChanged> Calling = *Watchers;
+		bool bAnyDead = false;
+		for (const FArtilleryAttributeChanged& Watcher : Calling)
+		{
+			if (!Watcher.IsBound())
+			{
+				bAnyDead = true;
+				continue;
+			}
+			Watcher.Execute(Change.Key.Key, Change.Key.Value, Change.Value);
+		}
+		if (bAnyDead)
+		{
+			if ((Watchers = AttributeWatchers.Find(Change.Key)) != nullptr)
+			{
+				Watchers->RemoveAll([](const FArtilleryAttributeChanged& Watcher) { return !Watcher.IsBound(); });
+				if (Watchers->IsEmpty())
+				{
+					AttributeWatchers.Remove(Change.Key);
+					PublishedSimState->Unwatch(Change.Key.Key, Change.Key.Value);
+				}
+			}
+		}
+	}
+}
+
+//per instance set transform calls dirty the ism's render state once each. with a few thousand projectiles up, that's
+//most of the game thread. instead, each mesh manager collects its updates and writes them in one go.
+void UArtilleryDispatch::ApplyTransformUpdatesBatched(UTransformDispatch* TransformECS)
+{
+	if (!ForwardedTransforms.IsValid())
+	{
+		return;
+	}
+	UArtilleryProjectileDispatch* Projectiles = GetWorld()->GetSubsystem<UArtilleryProjectileDispatch>();
+	TTransformPumpElement<TransformUpdatesForGameThread>::Type Update;
+	//snapshotted keys never show up in here. this is players, statics that moved, and anything that didn't get a slot.
+	while (ForwardedTransforms->Dequeue(Update))
+	{
+		const FSkeletonKey Key = FSkeletonKey(Update.ObjectKey);
+		AInstancedMeshManager* Manager = Projectiles ? Projectiles->GetProjectileMeshManagerByProjectileKey(Key).Get() : nullptr;
+		if (Manager)
+		{
+			if (Manager->QueueInstanceTransform(Key, FVector(Update.Position), FQuat(Update.Rotation)))
+			{
+				InstanceManagersToFlush.Add(Manager);
+			}
+			continue;
+		}
+		if (!PassthroughTransforms->Enqueue(Update))
+		{
+			//full. drain what we have and keep going.
+			TransformECS->ApplyTransformUpdates<TSharedPtr<TransformUpdatesForGameThread>>(PassthroughTransforms);
+			PassthroughTransforms->Enqueue(Update);
+		}
+	}
+	TransformECS->ApplyTransformUpdates<TSharedPtr<TransformUpdatesForGameThread>>(PassthroughTransforms);
+
+	//only the newest pair per key, and only for managers someone can see.
+	const float Alpha = TransformSnapshots->GetAlpha(FPlatformTime::Seconds());
+	SnapshotReaders.RemoveAllSwap([](const TWeakObjectPtr<AInstancedMeshManager>& Reader) { return !Reader.IsValid(); });
+	for (const TWeakObjectPtr<AInstancedMeshManager>& Reader : SnapshotReaders)
+	{
+		if (Reader->InterpolateInstances(*TransformSnapshots, Alpha))
+		{
+			InstanceManagersToFlush.Add(Reader.Get());
+		}
+	}
+	for (AInstancedMeshManager* Manager : InstanceManagersToFlush)
+	{
+		Manager->FlushInstanceTransforms();
+	}
+	InstanceManagersToFlush.Reset();
+}
+
+//the busy worker is the pump's producer (via the step), so draining it here keeps it single threaded at both ends.
+//a full forward queue drops the update. the next tick's update for that key supersedes it anyway.
+void UArtilleryDispatch::PublishTransformSnapshots()
+{
+	if (!TransformUpdateQueue.IsValid() || !TransformSnapshots.IsValid())
+	{
+		return;
+	}
+	TransformSnapshots->SyncSlots();
+	TTransformPumpElement<TransformUpdatesForGameThread>::Type Update;
+	while (TransformUpdateQueue->Dequeue(Update))
+	{
+		if (!TransformSnapshots->Write(FSkeletonKey(Update.ObjectKey), Update.Position, Update.Rotation))
+		{
+			ForwardedTransforms->Enqueue(Update);
+		}
+	}
+	TransformSnapshots->PublishTick(FPlatformTime::Seconds());
+}
+
+//no subsystem lookup at all, the pillar's cached at begin play. the worker is off the game thread, so it shouldn't
+//be walking the world's subsystem map anyway.
+void UArtilleryDispatch::GatherShadowLocations(TConstArrayView<FSkeletonKey> Keys, TArray<FVector3d>& Out, TBitArray<>& Found)
+{
+	UTransformDispatch* TransformECSPillar = TransformECSPillarCache;
+	if (!TransformECSPillar)
+	{
+		return;
+	}
+	Out.Reserve(Keys.Num());
+	Found.Init(false, Keys.Num());
+	for (int32 i = 0; i < Keys.Num(); ++i)
+	{
+		TOptional<FTransform> Shadow = TransformECSPillar->CopyOfTransformByObjectKey(Keys[i]);
+		Found[i] = Shadow.IsSet();
+		Out.Add(Shadow.IsSet() ? Shadow->GetLocation() : FVector3d::ZeroVector);
+	}
+}
+
+//barrage feeds are per thread, so the casts stay on the thread that called us. that's the busy worker, which got its
+//feed in ThreadSetup. task graph threads never did, so no ParallelFor here.
+void UArtilleryDispatch::RunShapeCasts(TConstArrayView<FShapeCastQuery> Queries, TArray<TSharedPtr<FHitResult>>& Results)
+{
+	UBarrageDispatch* Physics = PhysicsECSPillarCache;
+	if (!Physics)
+	{
+		return;
+	}
+	for (int32 Index = 0; Index < Queries.Num(); ++Index)
+	{
+		const FShapeCastQuery& Query = Queries[Index];
+		Physics->SphereCast(Query.Source, Query.Radius, Query.Distance, Query.Start, Query.Direction, Results[Index]);
 	}
 }
 
@@ -173,26 +447,44 @@ TStatId UArtilleryDispatch::GetStatId() const
 
 
 FGunKey UArtilleryDispatch::GetGun(FString GunDefinitionID, ActorKey ProbableOwner)
+{
+	GunDefinitionID = GunDefinitionID.IsEmpty() ? "M6D" : GunDefinitionID; //joking aside, an obvious debug val is needed.
+	const FGunDefinitionKeyParts Parts = FGunDefinitionKeyParts(GunDefinitionID);
+	DefinitionKeyParts.FindOrAdd(Parts.Index, Parts);
+	return GetGun(Parts.Index, ProbableOwner);
+}
+
+FGunKey UArtilleryDispatch::GetGun(uint32 GunDefinitionIndex, ActorKey ProbableOwner)
 {
 	//We know it. We have known it. We continue to know it.
 	//See you soon, Chief.
-	GunDefinitionID = GunDefinitionID.IsEmpty() ? "M6D" : GunDefinitionID; //joking aside, an obvious debug val is needed.
-	FGunKey Key = FGunKey(GunDefinitionID, monotonkey++);
-	TMap<AttribKey, double> InitialGunAttributes = TMap<AttribKey, double>();
-	if(PooledGuns.Contains(GunDefinitionID))
+	const FGunDefinitionKeyParts* Parts = DefinitionKeyParts.Find(GunDefinitionIndex);
+	if (!Parts)
 	{
-		TSharedPtr<FArtilleryGun> repurposing = *PooledGuns.Find(GunDefinitionID);
-		PooledGuns.RemoveSingle(GunDefinitionID, repurposing);
-		repurposing->Initialize(Key, false);
+		Parts = &DefinitionKeyParts.Add(GunDefinitionIndex, FGunDefinitionKeyParts(FGunDefinitionIds::Resolve(GunDefinitionIndex)));
+	}
+	FGunKey Key = FGunKey(*Parts, monotonkey++);
+	if(PooledGuns.Contains(Key.GunDefinitionIndex))
+	{
+		TSharedPtr<FArtilleryGun> repurposing = *PooledGuns.Find(Key.GunDefinitionIndex);
+		//pooled guns were prewarmed with SharesAbilities set.
+		PooledGuns.RemoveSingle(Key.GunDefinitionIndex, repurposing);
+		//owner first. initialize resolves the owner's components.
 		repurposing->UpdateProbableOwner(ProbableOwner);
+		repurposing->Initialize(Key, false);
 		GunByKey->Add(Key, repurposing);
+		GunByKeyChanges.Enqueue({Key, repurposing});
 	}
 	else
 	{
+		UE_LOG(LogTemp, Warning, TEXT("ArtilleryDispatch: pool for %s is empty, building a gun mid-match. Raise its PrewarmCount."), *Key.GetGunDefinitionID());
 		TSharedPtr<FArtilleryGun> NewGun = MakeShareable(new FArtilleryGun(Key));
-		NewGun->Initialize(Key, false);
+		NewGun->SharesAbilities = true;
+		NewGun->BindDispatch(this);
 		NewGun->UpdateProbableOwner(ProbableOwner);
+		NewGun->Initialize(Key, false);
 		GunByKey->Add(Key, NewGun);
+		GunByKeyChanges.Enqueue({Key, NewGun});
 	}
 	return Key;	
 }
@@ -203,9 +495,131 @@ FGunKey UArtilleryDispatch::RegisterExistingGun(FArtilleryGun* ToBind, ActorKey
 	TSharedPtr<FArtilleryGun> NewGun = MakeShareable(ToBind);
 	NewGun->UpdateProbableOwner(ProbableOwner);
 	GunByKey->Add(ToBind->MyGunKey, NewGun);
+	GunByKeyChanges.Enqueue({ToBind->MyGunKey, NewGun});
 	return ToBind->MyGunKey;	
 }
 
+//the allocation half of GetGun, paid up front. pooled guns have their abilities and attribute block but no key,
+//so they don't show up in the attribute mappings until they're handed out.
+void UArtilleryDispatch::PrewarmGuns(const FString& GunDefinitionID, int32 Count)
+{
+	const FGunDefinitionKeyParts Parts = FGunDefinitionKeyParts(GunDefinitionID);
+	DefinitionKeyParts.Add(Parts.Index, Parts);
+	const FGunKey Unassigned = FGunKey(Parts, UINT64_MAX);
+	GunByKey->Reserve(GunByKey->Num() + Count);
+	AttributeSetToDataMapping->Reserve(AttributeSetToDataMapping->Num() + Count);
+	for (int32 i = 0; i < Count; ++i)
+	{
+		TSharedPtr<FArtilleryGun> Pooled = MakeShareable(new FArtilleryGun(Unassigned));
+		Pooled->BindDispatch(this);
+		Pooled->SharesAbilities = true;
+		Pooled->Prewarm();
+		PooledGuns.Add(Unassigned.GunDefinitionIndex, Pooled);
+	}
+}
+
+//Abilities can't store anything, and the gun key comes in with each activation, so every gun of a definition can run
+//through the same seven objects. that's seven rooted uobjects per definition instead of per gun. rooted here, unrooted
+//in Deinitialize, and nowhere else.
+const FArtilleryAbilitySet& UArtilleryDispatch::GetSharedAbilities(uint32 GunDefinitionIndex)
+{
+	if (const FArtilleryAbilitySet* Found = SharedAbilitySets.Find(GunDefinitionIndex))
+	{
+		return *Found;
+	}
+	//the definition names a class for each phase. a definition the blob doesn't know, or a slot it leaves empty,
+	//gets the bare minimum ability, same as before there was a blob.
+	const FGunDefinitionRecord* Definition = FindGunDefinition(GunDefinitionIndex);
+	if (!Definition)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("ArtilleryDispatch: no gun definition for %s, its guns get default abilities and stats."), *FGunDefinitionIds::Resolve(GunDefinitionIndex));
+	}
+	auto MakePhase = [Definition](ArtilleryGunBlob::EAbilitySlot Slot) -> UArtilleryPerActorAbilityMinimum*
+	{
+		UClass* PhaseClass = UArtilleryPerActorAbilityMinimum::StaticClass();
+		const FString Path = Definition ? FGunDefinitionBlob::Get().GetString(Definition->Abilities[Slot]) : FString();
+		if (!Path.IsEmpty())
+		{
+			if (UClass* Loaded = LoadClass<UArtilleryPerActorAbilityMinimum>(nullptr, *Path))
+			{
+				PhaseClass = Loaded;
+			}
+			else
+			{
+				UE_LOG(LogTemp, Error, TEXT("ArtilleryDispatch: couldn't load ability %s, using the default."), *Path);
+			}
+		}
+		return NewObject<UArtilleryPerActorAbilityMinimum>(GetTransientPackage(), PhaseClass);
+	};
+	FArtilleryAbilitySet NewSet;
+	NewSet.Prefire = MakePhase(ArtilleryGunBlob::PreFire);
+	NewSet.PrefireCosmetic = MakePhase(ArtilleryGunBlob::PreFireCosmetic);
+	NewSet.Fire = MakePhase(ArtilleryGunBlob::Fire);
+	NewSet.FireCosmetic = MakePhase(ArtilleryGunBlob::FireCosmetic);
+	NewSet.PostFire = MakePhase(ArtilleryGunBlob::PostFire);
+	NewSet.PostFireCosmetic = MakePhase(ArtilleryGunBlob::PostFireCosmetic);
+	NewSet.FailedFireCosmetic = MakePhase(ArtilleryGunBlob::FailureCosmetic);
+	NewSet.ForEach([](UArtilleryPerActorAbilityMinimum* Phase)
+	{
+		Phase->AddToRoot();
+	});
+	BindGunPhases(NewSet.Prefire, NewSet.Fire);
+	return SharedAbilitySets.Add(GunDefinitionIndex, NewSet);
+}
+
+void UArtilleryDispatch::BindGunPhases(UArtilleryPerActorAbilityMinimum* Prefire, UArtilleryPerActorAbilityMinimum* Fire)
+{
+	Prefire->GunBinder.BindUObject(this, &UArtilleryDispatch::OnGunPhaseEnded, true);
+	Fire->GunBinder.BindUObject(this, &UArtilleryDispatch::OnGunPhaseEnded, false);
+}
+
+//the key came in with the activation, so a shared phase reaches the gun that fired it, not whichever gun bound it last.
+void UArtilleryDispatch::OnGunPhaseEnded(FGunKey Gun, FArtilleryStates OutcomeStates, int DallyFramesToOmit, const FGameplayAbilityActorInfo* ActorInfo, const FGameplayAbilityActivationInfo ActivationInfo, bool PrefireEnded)
+{
+	if (const TSharedPtr<FArtilleryGun> Found = GunByKey->FindRef(Gun))
+	{
+		Found->OnPhaseEnded(PrefireEnded, OutcomeStates, DallyFramesToOmit, ActorInfo, ActivationInfo);
+	}
+}
+
+//guns of one definition almost always agree on their stats, so they share one block. one that doesn't, a mock built
+//with its own numbers say, gets a block of its own rather than someone else's. the definition's record wins over the
+//gun's own numbers for anything it sets. ammo and reload aren't in the record yet, so those still come from the gun.
+TSharedPtr<const TMap<AttribKey, double>> UArtilleryDispatch::GetAttributeTemplate(uint32 GunDefinitionIndex, int MaxAmmo, int Firerate, int ReloadTime)
+{
+	const FGunDefinitionRecord* Definition = FindGunDefinition(GunDefinitionIndex);
+	if (Definition && Definition->BaseRateOfFire > 0)
+	{
+		Firerate = Definition->BaseRateOfFire;
+	}
+	const int Range = Definition ? Definition->BaseRange : 0;
+	auto Matches = [&](const TMap<AttribKey, double>& Template)
+	{
+		return Template.FindRef(MAX_AMMO) == MaxAmmo && Template.FindRef(COOLDOWN) == Firerate && Template.FindRef(RELOAD) == ReloadTime
+			&& Template.FindRef(AttribKey::Range) == Range;
+	};
+	const TSharedPtr<const TMap<AttribKey, double>>* Found = AttributeTemplates.Find(GunDefinitionIndex);
+	if (Found && Matches(**Found))
+	{
+		return *Found;
+	}
+	TSharedPtr<TMap<AttribKey, double>> Template = MakeShareable(new TMap<AttribKey, double>());
+	Template->Add(AMMO, MaxAmmo);
+	Template->Add(MAX_AMMO, MaxAmmo);
+	Template->Add(COOLDOWN, Firerate);
+	Template->Add(COOLDOWN_REMAINING, 0);
+	Template->Add(RELOAD, ReloadTime);
+	Template->Add(RELOAD_REMAINING, 0);
+	Template->Add(AttribKey::Range, Range);
+	Template->Add(TICKS_SINCE_GUN_LAST_FIRED, 0);
+	Template->Add(AttribKey::LastFiredTimestamp, 0);
+	if (!Found)
+	{
+		AttributeTemplates.Add(GunDefinitionIndex, Template);
+	}
+	return Template;
+}
+
 //returns false if already released.
 bool UArtilleryDispatch::ReleaseGun(FGunKey Key, FireControlKey MachineKey)
 {
@@ -216,7 +630,10 @@ bool UArtilleryDispatch::ReleaseGun(FGunKey Key, FireControlKey MachineKey)
 		
 		TSharedPtr<FArtilleryGun> tracker;
 		GunByKey->RemoveAndCopyValue(Key, tracker);
-		PooledGuns.Add(Key.GunDefinitionID, tracker);
+		GunByKeyChanges.Enqueue({Key, nullptr});
+		//the final tick resolver was registered under this key. the gun gets a new one when it comes back out of the pool.
+		RetireTicklitesOwnedBy(Key);
+		PooledGuns.Add(Key.GunDefinitionIndex, tracker);
 		return true;
 	}
 	return false;	
@@ -232,15 +649,15 @@ void UArtilleryDispatch::QueueResim(FGunKey Key, ArtilleryTime Time)
 
 AttrPtr UArtilleryDispatch::GetAttrib(FSkeletonKey Owner, AttribKey Attrib)
 {
-		if(AttributeSetToDataMapping->Contains(Owner))
+	const TMap<FSkeletonKey, AttrMapPtr>& Mapping = IsInGameThread() ? *AttributeSetToDataMapping : SimAttributeSetToDataMapping;
+	if (const AttrMapPtr* Attributes = Mapping.Find(Owner))
+	{
+		if (const AttrPtr* Found = (*Attributes)->Find(Attrib))
 		{
-			auto a = AttributeSetToDataMapping->FindChecked(Owner);
-			if(a->Contains(Attrib))
-			{
-				return a->FindChecked(Attrib);
-			}
+			return *Found;
 		}
-		return nullptr;
+	}
+	return nullptr;
 }
 
 IdentPtr UArtilleryDispatch::GetIdent(FSkeletonKey Owner, Ident Attrib)
@@ -275,6 +692,68 @@ void UArtilleryDispatch::RunGuns()
 		}
 		RequestorQueue_Abilities_TripleBuffer->Read().Reset();
 	}
+
+	FArtilleryFireCue Cue;
+	while (FireCues && FireCues->Dequeue(Cue))
+	{
+		if (auto Cosmetics = GunToCueFunctionMapping->Find(Cue.Gun))
+		{
+			Cosmetics->ExecuteIfBound(GunByKey->FindRef(Cue.Gun), Cue.Fired);
+		}
+	}
+}
+
+//Busy worker, once per sim frame, before the ability requests are handed to the game thread.
+//any gun that opts in gets its mechanical resolution here at sim rate, in the sorted request order, and is pulled out of
+//the requests so the game thread never runs it through GAS. The game thread only gets a cue to play.
+//guns are looked up in SimGunByKey, which only this thread touches. see GunByKeyChanges.
+void UArtilleryDispatch::ResolveGunsOnSimThread(EventBuffer& Requested)
+{
+	const ArtilleryTime Now = GetShadowNow();
+	Requested.RemoveAll([this, Now](const TPair<BristleTime, FGunKey>& Request)
+	{
+		TSharedPtr<FArtilleryGun> Gun = SimGunByKey.FindRef(Request.Value);
+		if (!Gun.IsValid() || !Gun->ResolvesOnSimThread)
+		{
+			return false;
+		}
+		FArtilleryFireCue Cue;
+		Cue.Time = Request.Key;
+		Cue.Gun = Request.Value;
+		Cue.Fired = Gun->SimFireGun(Now);
+		FireCues->Enqueue(Cue); //a dropped cue is a missing muzzle flash, not a missing shot.
+		return true;
+	});
+}
+
+//an add and a remove for the same key come off in the order the game thread made them, so replaying them in order
+//leaves us where it was.
+void UArtilleryDispatch::TakeSimMappingChanges()
+{
+	TPair<FGunKey, TSharedPtr<FArtilleryGun>> GunChange;
+	while (GunByKeyChanges.Dequeue(GunChange))
+	{
+		if (GunChange.Value.IsValid())
+		{
+			SimGunByKey.Add(GunChange.Key, GunChange.Value);
+		}
+		else
+		{
+			SimGunByKey.Remove(GunChange.Key);
+		}
+	}
+	TPair<FSkeletonKey, AttrMapPtr> AttributeChange;
+	while (AttributeSetChanges.Dequeue(AttributeChange))
+	{
+		if (AttributeChange.Value.IsValid())
+		{
+			SimAttributeSetToDataMapping.Add(AttributeChange.Key, AttributeChange.Value);
+		}
+		else
+		{
+			SimAttributeSetToDataMapping.Remove(AttributeChange.Key);
+		}
+	}
 }
 
 //this needs work and extension.
@@ -337,13 +816,37 @@ void UArtilleryDispatch::RERunLocomotions()
 	throw;
 }
 
-void UArtilleryDispatch::LoadGunData()
+//no parsing, no string lookups. map it and go.
+bool UArtilleryDispatch::LoadGunData()
 {
-#if UE_BUILD_SHIPPING != 0
-		throw;
+	const FString Path = FGunDefinitionBlob::DefaultPath();
+	FGunDefinitionBlob& GunDefinitions = FGunDefinitionBlob::Get();
+#if !UE_BUILD_SHIPPING
+	//a compile that landed while nothing was running.
+	if (GunDefinitions.SwapInPending(Path))
+	{
+		return true;
+	}
 #endif
-	FString AccumulatePath = FPaths::Combine(FPaths::ProjectPluginsDir(), "Artillery", "Data", "GunData");
-		
+	//another world got here first.
+	return GunDefinitions.IsLoaded() || GunDefinitions.Open(Path);
+}
+
+const FGunDefinitionRecord* UArtilleryDispatch::FindGunDefinition(uint32 GunDefinitionIndex) const
+{
+	return FGunDefinitionBlob::Get().Find(GunDefinitionIndex);
+}
+
+void UArtilleryDispatch::PrewarmFromGunData()
+{
+	const FGunDefinitionBlob& GunDefinitions = FGunDefinitionBlob::Get();
+	for (const FGunDefinitionRecord& Record : GunDefinitions.GetRecords())
+	{
+		if (Record.PrewarmCount > 0)
+		{
+			PrewarmGuns(GunDefinitions.GetString(Record.GunDefinitionId), Record.PrewarmCount);
+		}
+	}
 }
 //unused atm, but will be the way to ask for an eventish or triggered gun to fire, probably.
 void UArtilleryDispatch::QueueFire(FGunKey Key, ArtilleryTime Time)
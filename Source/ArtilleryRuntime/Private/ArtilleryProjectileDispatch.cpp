@@ -2,16 +2,19 @@
 
 #include "ArtilleryProjectileDispatch.h"
 #include "BarrageDispatch.h"
+#include "FTProjectileContactResolver.h"
+#include "Engine/StaticMesh.h"
+
+//this used to be StaticLoadObject'd in Initialize. now it's streamed in at begin play along with every mesh it names.
+static const FSoftObjectPath ProjectileDefinitionsPath = FSoftObjectPath(TEXT("/Game/DataTables/ProjectileDefinitions.ProjectileDefinitions"));
 
 void UArtilleryProjectileDispatch::Initialize(FSubsystemCollectionBase& Collection)
 {
 	Super::Initialize(Collection);
-	// TODO: Can we find and autoload the datatable, or do 
-	ProjectileDefinitions = Cast<UDataTable>(StaticLoadObject(UDataTable::StaticClass(), nullptr, TEXT("DataTable'/Game/DataTables/ProjectileDefinitions.ProjectileDefinitions'")));
+	ProjectileDefinitions = nullptr;
 	ManagerKeyToMeshManagerMapping = MakeShareable(new TMap<FSkeletonKey, TWeakObjectPtr<AInstancedMeshManager>>());
 	ProjectileKeyToMeshManagerMapping = MakeShareable(new TMap<FSkeletonKey, TWeakObjectPtr<AInstancedMeshManager>>());
-	ProjectileNameToMeshManagerMapping = MakeShareable(new TMap<FName, TWeakObjectPtr<AInstancedMeshManager>>());
-	SelfPtr = this;
+	ContactsToResolve = MakeShareable(new ProjectileContactQueue(4096));
 	UE_LOG(LogTemp, Warning, TEXT("ArtilleryProjectileDispatch:Subsystem: Online"));
 }
 
@@ -25,6 +28,12 @@ void UArtilleryProjectileDispatch::OnWorldBeginPlay(UWorld& InWorld)
 	Super::OnWorldBeginPlay(InWorld);
 	UBarrageDispatch* BarrageDispatch = GetWorld()->GetSubsystem<UBarrageDispatch>();
 	BarrageDispatch->OnBarrageContactAddedDelegate.AddUObject(this, &UArtilleryProjectileDispatch::OnBarrageContactAdded);
+	MyDispatch = GetWorld()->GetSubsystem<UArtilleryDispatch>();
+	TLProjectileContactResolver Resolver = TLProjectileContactResolver(ContactsToResolve, this);
+	MyDispatch->RequestAddTicklite(MakeShareable(new ProjectileContactResolver(Resolver)), FINAL_TICK_RESOLVE);
+	DefinitionsLoadHandle = StreamableManager.RequestAsyncLoad(
+		ProjectileDefinitionsPath,
+		FStreamableDelegate::CreateUObject(this, &UArtilleryProjectileDispatch::OnProjectileDefinitionsLoaded));
 }
 
 void UArtilleryProjectileDispatch::Deinitialize()
@@ -32,7 +41,120 @@ void UArtilleryProjectileDispatch::Deinitialize()
 	Super::Deinitialize();
 	ManagerKeyToMeshManagerMapping->Empty();
 	ProjectileKeyToMeshManagerMapping->Empty();
-	ProjectileNameToMeshManagerMapping->Empty();
+	ArchetypeIndexByName.Empty();
+	ArchetypeIndexByManagerKey.Empty();
+	Archetypes.Empty();
+	//the busy worker's gone by now, so nothing else is touching these.
+	SimProjectileDamage.Empty();
+	LifeChanges.Empty();
+	ContactedProjectiles.Empty();
+	SimArchetypes.Empty();
+	SimArchetypeChanges.Empty();
+	SimSpawned.Empty();
+	MyDispatch = nullptr;
+	if (MeshesLoadHandle.IsValid())
+	{
+		MeshesLoadHandle->CancelHandle();
+		MeshesLoadHandle.Reset();
+	}
+	if (DefinitionsLoadHandle.IsValid())
+	{
+		DefinitionsLoadHandle->CancelHandle();
+		DefinitionsLoadHandle.Reset();
+	}
+}
+
+//game thread, fired by the streamable manager once the table is in memory.
+//every row gets an archetype slot and its mesh gets queued for one batched async load.
+void UArtilleryProjectileDispatch::OnProjectileDefinitionsLoaded()
+{
+	ProjectileDefinitions = Cast<UDataTable>(ProjectileDefinitionsPath.ResolveObject());
+	if (ProjectileDefinitions == nullptr)
+	{
+		UE_LOG(LogTemp, Error, TEXT("ArtilleryProjectileDispatch: could not load projectile definitions from %s"), *ProjectileDefinitionsPath.ToString());
+		return;
+	}
+
+	TArray<FSoftObjectPath> MeshPaths;
+	ProjectileDefinitions->ForeachRow<FProjectileDefinitionRow>(TEXT("ProjectileArchetypeCache"),
+		[this, &MeshPaths](const FName& RowName, const FProjectileDefinitionRow& Row)
+		{
+			FProjectileArchetype& Archetype = Archetypes[GetProjectileArchetypeIndex(RowName)];
+			Archetype.MeshPath = FSoftObjectPath(Row.ProjectileMeshLocation);
+			Archetype.ImpactDamage = Row.ImpactDamage;
+			MeshPaths.AddUnique(Archetype.MeshPath);
+		});
+
+	if (!MeshPaths.IsEmpty())
+	{
+		MeshesLoadHandle = StreamableManager.RequestAsyncLoad(
+			MeshPaths,
+			FStreamableDelegate::CreateUObject(this, &UArtilleryProjectileDispatch::OnProjectileMeshesLoaded));
+	}
+}
+
+void UArtilleryProjectileDispatch::OnProjectileMeshesLoaded()
+{
+	for (int32 Index = 0; Index < Archetypes.Num(); ++Index)
+	{
+		BindArchetype(Index);
+	}
+	UE_LOG(LogTemp, Display, TEXT("ArtilleryProjectileDispatch: %d projectile archetypes ready"), Archetypes.Num());
+}
+
+//spawns the mesh manager for an archetype whose mesh is already in memory. the manager caches the bounds and
+//shape params when the mesh is set, so after this the archetype is fully compiled.
+bool UArtilleryProjectileDispatch::BindArchetype(const int32 ArchetypeIndex)
+{
+	FProjectileArchetype& Archetype = Archetypes[ArchetypeIndex];
+	if (Archetype.MeshManager.IsValid())
+	{
+		return true;
+	}
+
+	Archetype.Mesh = Cast<UStaticMesh>(Archetype.MeshPath.ResolveObject());
+	if (!Archetype.Mesh.IsValid())
+	{
+		return false;
+	}
+
+	//deferred, so the manager has its key before we file it under that key. this can run inside our own begin play,
+	//before any actor's BeginPlay.
+	AInstancedMeshManager* NewMeshManager = GetWorld()->SpawnActorDeferred<AInstancedMeshManager>(AInstancedMeshManager::StaticClass(), FTransform::Identity);
+	NewMeshManager->Prime();
+	NewMeshManager->SetStaticMesh(Archetype.Mesh.Get());
+	NewMeshManager->FinishSpawning(FTransform::Identity);
+	ManagerKeyToMeshManagerMapping->Add(NewMeshManager->GetMyKey(), NewMeshManager);
+	ArchetypeIndexByManagerKey.Add(NewMeshManager->GetMyKey(), ArchetypeIndex);
+	Archetype.MeshManager = NewMeshManager;
+	SimArchetypeChanges.Enqueue({ArchetypeIndex, {NewMeshManager, Archetype.ImpactDamage}});
+	return true;
+}
+
+//this is the hitch we're trying to get rid of. it only runs if something fires before the preload finishes,
+//or names a projectile that isn't in the table.
+bool UArtilleryProjectileDispatch::BindArchetypeNow(const int32 ArchetypeIndex)
+{
+	FProjectileArchetype& Archetype = Archetypes[ArchetypeIndex];
+	UE_LOG(LogTemp, Warning, TEXT("ArtilleryProjectileDispatch: %s was fired before its archetype was preloaded. Loading synchronously."), *Archetype.ProjectileDefinitionId.ToString());
+
+	if (ProjectileDefinitions == nullptr)
+	{
+		ProjectileDefinitions = Cast<UDataTable>(StreamableManager.LoadSynchronous(ProjectileDefinitionsPath));
+	}
+	if (Archetype.MeshPath.IsNull())
+	{
+		if (const FProjectileDefinitionRow* ProjectileDefinition = GetProjectileDefinitionRow(Archetype.ProjectileDefinitionId))
+		{
+			Archetype.MeshPath = FSoftObjectPath(ProjectileDefinition->ProjectileMeshLocation);
+			Archetype.ImpactDamage = ProjectileDefinition->ImpactDamage;
+		}
+	}
+	if (!Archetype.MeshPath.IsNull())
+	{
+		Archetype.MeshPath.TryLoad();
+	}
+	return BindArchetype(ArchetypeIndex);
 }
 
 FProjectileDefinitionRow* UArtilleryProjectileDispatch::GetProjectileDefinitionRow(const FName ProjectileDefinitionId)
@@ -45,50 +167,180 @@ FProjectileDefinitionRow* UArtilleryProjectileDispatch::GetProjectileDefinitionR
 	return nullptr;
 }
 
+//Indices are dense and never reused, so resolve once when the gun is set up and hang onto it.
+//Asking for a name that hasn't loaded yet reserves its slot, and the preload fills it in.
+int32 UArtilleryProjectileDispatch::GetProjectileArchetypeIndex(const FName ProjectileDefinitionId)
+{
+	if (const int32* Found = ArchetypeIndexByName.Find(ProjectileDefinitionId))
+	{
+		return *Found;
+	}
+	FProjectileArchetype NewArchetype;
+	NewArchetype.ProjectileDefinitionId = ProjectileDefinitionId;
+	const int32 NewIndex = Archetypes.Add(NewArchetype);
+	ArchetypeIndexByName.Add(ProjectileDefinitionId, NewIndex);
+	return NewIndex;
+}
+
+TWeakObjectPtr<AInstancedMeshManager> UArtilleryProjectileDispatch::GetArchetypeMeshManager(const int32 ArchetypeIndex)
+{
+	if (!Archetypes.IsValidIndex(ArchetypeIndex))
+	{
+		return nullptr;
+	}
+	if (!Archetypes[ArchetypeIndex].MeshManager.IsValid() && !BindArchetypeNow(ArchetypeIndex))
+	{
+		return nullptr;
+	}
+	return Archetypes[ArchetypeIndex].MeshManager;
+}
+
 FSkeletonKey UArtilleryProjectileDispatch::CreateProjectileInstance(const FName ProjectileDefinitionId, const FTransform& WorldTransform, const FVector3d& MuzzleVelocity, const bool IsSensor)
 {
-	auto MeshManagerPtr = ProjectileNameToMeshManagerMapping->Find(ProjectileDefinitionId);
+	return CreateProjectileInstance(GetProjectileArchetypeIndex(ProjectileDefinitionId), WorldTransform, MuzzleVelocity, IsSensor);
+}
+
+FSkeletonKey UArtilleryProjectileDispatch::CreateProjectileInstance(const int32 ArchetypeIndex, const FTransform& WorldTransform, const FVector3d& MuzzleVelocity, const bool IsSensor)
+{
+	TWeakObjectPtr<AInstancedMeshManager> MeshManager = GetArchetypeMeshManager(ArchetypeIndex);
+	if (MeshManager.IsValid())
+	{
+		FSkeletonKey NewProjectileKey = MeshManager->CreateNewInstance(WorldTransform, MuzzleVelocity, Layers::PROJECTILE, IsSensor);
+		ProjectileKeyToMeshManagerMapping->Add(NewProjectileKey, MeshManager);
+		LifeChanges.Enqueue({NewProjectileKey, Archetypes[ArchetypeIndex].ImpactDamage});
+		return NewProjectileKey;
+	}
+
+	UE_LOG(LogTemp, Error, TEXT("Could not find or load projectile instance manager for archetype %d"), ArchetypeIndex);
+	return FSkeletonKey();
+}
+
+int32 UArtilleryProjectileDispatch::CreateProjectileInstances(const FName ProjectileDefinitionId, TArrayView<const FTransform> WorldTransforms, TArrayView<const FVector3d> MuzzleVelocities, const bool IsSensor, TArray<FSkeletonKey>& OutKeys)
+{
+	return CreateProjectileInstances(GetProjectileArchetypeIndex(ProjectileDefinitionId), WorldTransforms, MuzzleVelocities, IsSensor, OutKeys);
+}
 
-	if (!MeshManagerPtr || !MeshManagerPtr->IsValid())
+//one lookup, one bulk instance add, one reserve. keys are appended to OutKeys in the same order as the transforms.
+//returns the number of projectiles created, which is either all of them or none of them.
+int32 UArtilleryProjectileDispatch::CreateProjectileInstances(const int32 ArchetypeIndex, TArrayView<const FTransform> WorldTransforms, TArrayView<const FVector3d> MuzzleVelocities, const bool IsSensor, TArray<FSkeletonKey>& OutKeys)
+{
+	if (WorldTransforms.Num() != MuzzleVelocities.Num())
 	{
-		if (const FProjectileDefinitionRow* ProjectileDefinition = GetProjectileDefinitionRow(ProjectileDefinitionId))
+		UE_LOG(LogTemp, Error, TEXT("CreateProjectileInstances for archetype %d got %d transforms but %d velocities"), ArchetypeIndex, WorldTransforms.Num(), MuzzleVelocities.Num());
+		return 0;
+	}
+
+	TWeakObjectPtr<AInstancedMeshManager> MeshManager = GetArchetypeMeshManager(ArchetypeIndex);
+	if (MeshManager.IsValid())
+	{
+		const int32 FirstNewKey = OutKeys.Num();
+		MeshManager->CreateNewInstances(WorldTransforms, MuzzleVelocities, Layers::PROJECTILE, IsSensor, OutKeys);
+		ProjectileKeyToMeshManagerMapping->Reserve(ProjectileKeyToMeshManagerMapping->Num() + WorldTransforms.Num());
+		const double ImpactDamage = Archetypes[ArchetypeIndex].ImpactDamage;
+		for (int32 i = FirstNewKey; i < OutKeys.Num(); ++i)
 		{
-			if (UStaticMesh* StaticMeshPtr = Cast<UStaticMesh>(StaticLoadObject(UStaticMesh::StaticClass(), nullptr, *ProjectileDefinition->ProjectileMeshLocation)))
-			{
-				AInstancedMeshManager* NewMeshManager = GetWorld()->SpawnActor<AInstancedMeshManager>();
-				NewMeshManager->SetStaticMesh(StaticMeshPtr);
-				ManagerKeyToMeshManagerMapping->Add(NewMeshManager->GetMyKey(), NewMeshManager);
-				ProjectileNameToMeshManagerMapping->Add(ProjectileDefinitionId, NewMeshManager);
-			}
+			ProjectileKeyToMeshManagerMapping->Add(OutKeys[i], MeshManager);
+			LifeChanges.Enqueue({OutKeys[i], ImpactDamage});
 		}
+		return OutKeys.Num() - FirstNewKey;
 	}
 
-	MeshManagerPtr = ProjectileNameToMeshManagerMapping->Find(ProjectileDefinitionId);
+	UE_LOG(LogTemp, Error, TEXT("Could not find or load projectile instance manager for archetype %d"), ArchetypeIndex);
+	return 0;
+}
 
-	if(MeshManagerPtr)
+//the key and body are made here and now, so the shot's in the sim on the tick it was fired. the mesh follows on the
+//game thread's next tick. an archetype the sim hasn't been handed yet, still loading say, goes over whole and spawns
+//there instead, a frame late, and the key comes back empty.
+FSkeletonKey UArtilleryProjectileDispatch::CreateProjectileInstanceFromSim(const int32 ArchetypeIndex, const FTransform& WorldTransform, const FVector3d& MuzzleVelocity, const bool IsSensor)
+{
+	TPair<int32, FSimProjectileArchetype> Bound;
+	while (SimArchetypeChanges.Dequeue(Bound))
 	{
-		auto MeshManager = *MeshManagerPtr;
-		if (MeshManager.IsValid())
+		if (SimArchetypes.Num() <= Bound.Key)
 		{
-			FSkeletonKey NewProjectileKey = MeshManager->CreateNewInstance(WorldTransform, MuzzleVelocity, Layers::PROJECTILE, IsSensor);
-			ProjectileKeyToMeshManagerMapping->Add(NewProjectileKey, MeshManager);
-			return NewProjectileKey;
+			SimArchetypes.SetNum(Bound.Key + 1);
 		}
+		SimArchetypes[Bound.Key] = Bound.Value;
 	}
 
-	UE_LOG(LogTemp, Error, TEXT("Could not find or load projectile instance manager with id %s"), *ProjectileDefinitionId.ToString());
-	return FSkeletonKey();
+	FSimSpawnedProjectile Spawned;
+	Spawned.ArchetypeIndex = ArchetypeIndex;
+	Spawned.WorldTransform = WorldTransform;
+	Spawned.MuzzleVelocity = MuzzleVelocity;
+	Spawned.IsSensor = IsSensor;
+	if (SimArchetypes.IsValidIndex(ArchetypeIndex) && SimArchetypes[ArchetypeIndex].MeshManager)
+	{
+		const FSimProjectileArchetype& Archetype = SimArchetypes[ArchetypeIndex];
+		Spawned.Projectile = Archetype.MeshManager->CreateSimBody(WorldTransform, MuzzleVelocity, Layers::PROJECTILE, IsSensor);
+		TakeLifeChanges();
+		SimProjectileDamage.Add(Spawned.Projectile, Archetype.ImpactDamage);
+	}
+	SimSpawned.Enqueue(Spawned);
+	return Spawned.Projectile;
 }
 
-void UArtilleryProjectileDispatch::DeleteProjectile(const FSkeletonKey Target)
+//ahead of the contacted deletes, so anything the sim spawned and then hit in the same stretch has its mesh to delete.
+void UArtilleryProjectileDispatch::FinishSimSpawns()
+{
+	FSimSpawnedProjectile Spawned;
+	while (SimSpawned.Dequeue(Spawned))
+	{
+		if (Spawned.Projectile == FSkeletonKey())
+		{
+			CreateProjectileInstance(Spawned.ArchetypeIndex, Spawned.WorldTransform, Spawned.MuzzleVelocity, Spawned.IsSensor);
+			continue;
+		}
+		const TWeakObjectPtr<AInstancedMeshManager> MeshManager = Archetypes[Spawned.ArchetypeIndex].MeshManager;
+		if (MeshManager.IsValid())
+		{
+			MeshManager->AdoptSimInstance(Spawned.Projectile, Spawned.WorldTransform);
+			ProjectileKeyToMeshManagerMapping->Add(Spawned.Projectile, MeshManager);
+		}
+	}
+}
+
+//returns false if the projectile was already gone, which is how a second contact on the same projectile gets ignored.
+bool UArtilleryProjectileDispatch::DeleteProjectile(const FSkeletonKey Target)
 {
 	TWeakObjectPtr<AInstancedMeshManager> MeshManager;
 	bool FoundKey = ProjectileKeyToMeshManagerMapping->RemoveAndCopyValue(Target, MeshManager);
 	if (FoundKey && MeshManager.IsValid())
 	{
-		UE_LOG(LogTemp, Warning, TEXT("DELETING"));
 		MeshManager->CleanupInstance(Target);
-		ProjectileKeyToMeshManagerMapping->Remove(Target);
+	}
+	if (FoundKey)
+	{
+		//the lifespan resolver, and anything else riding on this projectile.
+		GetWorld()->GetSubsystem<UArtilleryDispatch>()->RetireTicklitesOwnedBy(Target);
+		//already gone from the busy worker's side if a contact is what's deleting it. this covers everything else.
+		LifeChanges.Enqueue({Target, -1});
+	}
+	return FoundKey;
+}
+
+void UArtilleryProjectileDispatch::DeleteContactedProjectiles()
+{
+	FSkeletonKey Contacted;
+	while (ContactedProjectiles.Dequeue(Contacted))
+	{
+		DeleteProjectile(Contacted);
+	}
+}
+
+void UArtilleryProjectileDispatch::TakeLifeChanges()
+{
+	FProjectileLifeChange Change;
+	while (LifeChanges.Dequeue(Change))
+	{
+		if (Change.Damage < 0)
+		{
+			SimProjectileDamage.Remove(Change.Projectile);
+		}
+		else
+		{
+			SimProjectileDamage.Add(Change.Projectile, Change.Damage);
+		}
 	}
 }
 
@@ -112,6 +364,9 @@ TWeakObjectPtr<AInstancedMeshManager> UArtilleryProjectileDispatch::GetProjectil
 	return nullptr;
 }
 
+//Busy worker, once per contact, right after the step that found it. this only records the hit and takes the projectile
+//out of the sim's view so it can't hit again. damage is sorted and applied in bulk by TLProjectileContactResolver, and
+//the ism side goes on the game thread's next tick, in DeleteContactedProjectiles.
 void UArtilleryProjectileDispatch::OnBarrageContactAdded(const BarrageContactEvent& ContactEvent)
 {
 	// We only care if one of the entities is a projectile
@@ -120,24 +375,20 @@ void UArtilleryProjectileDispatch::OnBarrageContactAdded(const BarrageContactEve
 		auto ProjectileKey = ContactEvent.ContactEntity1.bIsProjectile ? ContactEvent.ContactEntity1.ContactKey : ContactEvent.ContactEntity2.ContactKey;
 		auto EntityHitKey = ContactEvent.ContactEntity1.bIsProjectile ? ContactEvent.ContactEntity2.ContactKey : ContactEvent.ContactEntity1.ContactKey;
 
-		UArtilleryDispatch* ArtilleryDispatch = GetWorld()->GetSubsystem<UArtilleryDispatch>();
-		UTransformDispatch* TransformDispatch = GetWorld()->GetSubsystem<UTransformDispatch>();
-		
-		// TODO: make action based on projectile configuration, not just 100 health damage
-		AttrPtr HitObjectHealthPtr = ArtilleryDispatch->GetAttrib(EntityHitKey, HEALTH);
-
-		if (HitObjectHealthPtr.IsValid())
+		TakeLifeChanges();
+		double Damage = 0;
+		if (SimProjectileDamage.RemoveAndCopyValue(ProjectileKey, Damage))
 		{
-			HitObjectHealthPtr->SetCurrentValue(HitObjectHealthPtr->GetCurrentValue() - 100);
-		}
-
-		auto HitActor = TransformDispatch->GetAActorByObjectKey(EntityHitKey);
-		if (HitActor.IsValid())
-		{
-			UE_LOG(LogTemp, Warning, TEXT("Hit a: %s"), *HitActor->GetFullName());
+			FProjectileContact Contact;
+			Contact.Projectile = ProjectileKey;
+			Contact.EntityHit = EntityHitKey;
+			Contact.Damage = Damage;
+			Contact.Stamp = MyDispatch ? MyDispatch->GetSimTick() : 0;
+			if (!ContactsToResolve->Enqueue(Contact))
+			{
+				UE_LOG(LogTemp, Error, TEXT("ArtilleryProjectileDispatch: contact queue full, dropping a hit."));
+			}
+			ContactedProjectiles.Enqueue(ProjectileKey);
 		}
-
-		DeleteProjectile(ProjectileKey);
 	}
-	
-}
\ No newline at end of file
+}
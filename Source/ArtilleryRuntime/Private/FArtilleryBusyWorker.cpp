@@ -14,76 +14,42 @@ FArtilleryBusyWorker::~FArtilleryBusyWorker()
 	UE_LOG(LogTemp, Display, TEXT("Artillery:BusyWorker: Destructing Artillery"));
 }
 
-bool FArtilleryBusyWorker::Init()
-{
-	//you cannot reorder these. it is a magic ordering put in place for a hack. 
-
-	UE_LOG(LogTemp, Display, TEXT("Artillery:BusyWorker: Initializing Artillery thread"));
-	running = true;
-	return true;
-}
-
-void FArtilleryBusyWorker::RunStandardFrameSim(bool& missedPrior, uint64_t& currentIndexCabling,
-                                               bool& burstDropDetected, TheCone::PacketElement& current,
-                                               bool& RemoteInput) const
+void FArtilleryBusyWorker::RunStandardFrameSim(FInputJitterBuffer& RemoteJitter, uint64_t& currentIndexCabling,
+                                               uint64_t SimTick, TheCone::PacketElement& current,
+                                               bool& RemoteInput)
 {
 	//this is an odd thing to do, I know, but we have some book-keeping we want to reserve for each code path.
 	//once this settles a little, I'll refactor, but I'm going to end up reworking this next weekend.
-	if (InputRingBuffer != nullptr  && !InputRingBuffer.Get()->IsEmpty())
+	const bool ReceivedRemote = InputRingBuffer != nullptr && !InputRingBuffer.Get()->IsEmpty();
+	while (InputRingBuffer != nullptr && !InputRingBuffer.Get()->IsEmpty())
 	{
-		while (InputRingBuffer != nullptr && !InputRingBuffer.Get()->IsEmpty())
-		{
-			const TheCone::Packet_tpl* packedInput = InputRingBuffer.Get()->Peek();
-			auto indexInput = packedInput->GetCycleMeta() + 3; //faster than 3xabs or a branch.
-			{
-				//unlike the old design, we use an array of inputs from first -> current
-				//so we want to add oldest first, then next, then next.
-				//we'll need to amend this to handle correct defaulting of missing input,
-				//which we can detect by both cycle skips and arrival window misses.
-				//we then need a way, during rollbacks, to perform the rewrite.
-				//right now, we just wait until we get the remote input.
-				if (missedPrior)
-				{
-					if (burstDropDetected)
-					{
-						//
-						BristleconeControlStream->Add(
-							*((TheCone::Packet_tpl*)(packedInput))->GetPointerToElement((indexInput - 2) % 3),
-							((TheCone::Packet_tpl*)(packedInput))->GetTransferTime());
-					}
-					BristleconeControlStream->Add(
-						*((TheCone::Packet_tpl*)(packedInput))->GetPointerToElement((indexInput - 1) % 3),
-						((TheCone::Packet_tpl*)(packedInput))->GetTransferTime()
-					);
-				}
-				BristleconeControlStream->Add(
-					*((TheCone::Packet_tpl*)(packedInput))->GetPointerToElement(indexInput % 3),
-					((TheCone::Packet_tpl*)(packedInput))->GetTransferTime());
-
-				RemoteInput = true; //we check for empty at the start of the while. no need to check again.
-				InputRingBuffer.Get()->Dequeue();
-			}
-		}
-
-		if (RemoteInput == true)
-		{
-			missedPrior = false;
-			burstDropDetected = false;
-		}
-		else
-		{
-			if (burstDropDetected)
-			{
-				//add rolling average switch-over here
-			}
-			if (missedPrior)
-			{
-				burstDropDetected = true;
-			}
-			missedPrior = true;
-		}
+		//every copy of every cycle goes into the jitter buffer. it sorts out the redundancy and decides when each
+		//cycle is due, so the old missed-prior and burst-drop guessing lives in there now, properly.
+		RemoteJitter.Ingest(*((TheCone::Packet_tpl*)(InputRingBuffer.Get()->Peek())), SimTick);
+		InputRingBuffer.Get()->Dequeue();
+	}
+	//anything that just came in for a cycle we already guessed at. the stream fixes its history and keeps the
+	//earliest wrong tick for rollback. right guesses cost nothing past clearing the mark.
+	RemoteJitter.TakeResolutions(Resolutions);
+	for (const FInputJitterBuffer::FResolution& Resolved : Resolutions)
+	{
+		BristleconeControlStream->Resolve(Resolved.StreamInput, Resolved.Real, Resolved.PlayedAt, Resolved.Diverged);
+		UE_CLOG(Resolved.Diverged, LogTemp, Verbose, TEXT("Artillery:BusyWorker: remote input %llu mispredicted on tick %llu"),
+			Resolved.StreamInput, Resolved.PlayedAt);
 	}
-	else if (InputSwapSlot != nullptr && !InputSwapSlot.Get()->IsEmpty())
+	if (const std::optional<uint64_t> Diverged = BristleconeControlStream->TakeEarliestDivergence())
+	{
+		ContingentDispatchLinkage->ReportInputDivergence(*Diverged);
+	}
+	//released every frame, packets or not. a cycle held back last frame can come due this one, and a cycle that's
+	//late gets the predictor's guess so we never stall waiting on it.
+	RemoteInput = RemoteJitter.Release(SimTick, [this](const FInputJitterBuffer::Element& Input, FInputJitterBuffer::TransferTime Sent, bool Predicted)
+	{
+		return BristleconeControlStream->Add(Input, Sent, Predicted);
+	});
+
+	//the remote path has done its book-keeping above, so local input only moves on a frame with no packets.
+	if (!ReceivedRemote && InputSwapSlot != nullptr && !InputSwapSlot.Get()->IsEmpty())
 	{
 		//though it's probably more elegant and faster to index over the control streams
 		while (InputSwapSlot != nullptr && !InputSwapSlot.Get()->IsEmpty())
@@ -94,7 +60,7 @@ void FArtilleryBusyWorker::RunStandardFrameSim(bool& missedPrior, uint64_t& curr
 			InputSwapSlot.Get()->Dequeue();
 		}
 	}
-	else
+	else if (!ReceivedRemote)
 	{
 		//----------------------------------
 		//if we got nothing, repeat prior.
@@ -150,6 +116,11 @@ void FArtilleryBusyWorker::RunStandardFrameSim(bool& missedPrior, uint64_t& curr
 	}
 	refDangerous_LifeCycleManaged_Loco_TripleBuffered.Sort();
 	refDangerous_LifeCycleManaged_Abilities_TripleBuffered.Sort();
+	//sort first. sim-resolved guns have to fire in a deterministic order, same as everything else.
+	if (ContingentDispatchLinkage)
+	{
+		ContingentDispatchLinkage->ResolveGunsOnSimThread(refDangerous_LifeCycleManaged_Abilities_TripleBuffered);
+	}
 	if (RequestorQueue_Abilities_TripleBuffer->IsDirty() == false)
 	{
 		RequestorQueue_Abilities_TripleBuffer->SwapWriteBuffers();
@@ -160,105 +131,99 @@ void FArtilleryBusyWorker::RunStandardFrameSim(bool& missedPrior, uint64_t& curr
 	}
 }
 
-uint32 FArtilleryBusyWorker::Run()
+bool FArtilleryBusyWorker::Begin()
 {
-	UE_LOG(LogTemp, Display, TEXT("Artillery:BusyWorker: Running Artillery thread"));
+	UE_LOG(LogTemp, Display, TEXT("Artillery:BusyWorker: Starting Artillery on a pool lane"));
 	if (RequestorQueue_Abilities_TripleBuffer == nullptr)
 	{
 #ifdef UE_BUILD_SHIPPING
-		return -1;
+		return false;
 #else
 		throw; // this is a BUG. A BAD ONE. 
 #endif
 	}
-	bool missedPrior = false;
-	uint64_t currentIndexCabling = 0;
-	uint64_t currentIndexBristlecone = 0;
-	bool burstDropDetected = false;
-	bool sent = false;
-	//TODO: remember why this needs to be an int. Overflow would take a match running for 1000 hours.
-	//if you wanna use this for a really long lived session, you'll need to fix it.
-	int seqNumber = 0;
-	//Hi! Jake here! Reminding you that this will CYCLE
+	RemoteJitter.SetPredictor(RemotePredictor);
 	//That's known. Isn't that fun? :) Don't reorder these, by the way.
-	uint32_t LastIncrementWindow = ContingentInputECSLinkage->Now();
-	uint32_t lsbTime = ContingentInputECSLinkage->Now();
-	constexpr uint32_t sampleHertz = TheCone::CablingSampleHertz;
-	constexpr uint32_t sendHertz = LongboySendHertz;
-	constexpr uint32_t sendHertzFactor = sampleHertz / sendHertz;
-	constexpr uint32_t Period = 1000000 / sampleHertz; //swap to microseconds. standardizing.
-
-	constexpr auto Step = std::chrono::milliseconds(Period / 2000);
+	LastIncrementWindow = ContingentInputECSLinkage->Now();
+	lsbTime = ContingentInputECSLinkage->Now();
 
-	//we can now start the sim. we latch only on the apply step.
-	StartTicklitesSim->Trigger();
 	//we are started by Artillery Dispatch, but we can't use it in the .h file to avoid dependencies.
 	//so we know it's live, but we don't take a ref to it until this point.
 	//we only use it for GrantFeed, but it's important that we start abiding by separation of concerns
 	//where we can, so we're trying to hide the barrage dependency here in a sense. We can't fully, but.
-	auto ArtilleryDispatch = ContingentInputECSLinkage->GetWorld()->GetSubsystem<UArtilleryDispatch>();
-	ArtilleryDispatch->ThreadSetup();
-	timeBeginPeriod(2);
-	while (running)
+	//the feed is granted to whatever lane this is, then kept, and Pump carries it to whichever lane runs us after.
+	//ticklites run inside the pump, so the one feed covers them too.
+	ContingentDispatchLinkage = ContingentInputECSLinkage->GetWorld()->GetSubsystem<UArtilleryDispatch>();
+	ContingentDispatchLinkage->ThreadSetup();
+	Feed = UBarrageDispatch::MyBARRAGEIndex;
+	running = true;
+	return true;
+}
+
+void FArtilleryBusyWorker::Pump()
+{
+	if (!running)
 	{
-		if (!sent &&
-			(
-				InputRingBuffer != nullptr && !InputRingBuffer.Get()->IsEmpty()
-				|| seqNumber % sendHertzFactor == 0 //last chance. Not good.
-			)
+		return;
+	}
+	//the last match this lane pumped left its own feed here.
+	UBarrageDispatch::MyBARRAGEIndex = Feed;
+	if (!sent &&
+		(
+			InputRingBuffer != nullptr && !InputRingBuffer.Get()->IsEmpty()
+			|| seqNumber % SendHertzFactor == 0 //last chance. Not good.
 		)
-		{
-			currentIndexCabling = CablingControlStream->highestInput;
-			currentIndexBristlecone = BristleconeControlStream->highestInput;
-			TheCone::PacketElement current = 0;
-			bool RemoteInput = false;
-			RunStandardFrameSim(missedPrior, currentIndexCabling, burstDropDetected, current, RemoteInput);
-			/*
-			*
-			* Jolt will go here? No point in updating if we need to reconcile first.
-			* Note: We also have Iris performing intermittent state stomps to recover from more serious desyncs.
-			* Ultimately, rollback can never solve everything. The window's just get too wide.
-			*/
-			
-			sent = true;
-			TickliteNow = ContingentInputECSLinkage->Now(); // this updates ONCE PER CYCLE. ONCE. THIS IS INTENDED.
-			
-			ArtilleryDispatch->RunLocomotions();
-			//such a simple thing, after all this work.
-			ContingentPhysicsLinkage->StackUp();
-			StartTicklitesApply->Trigger();
-			ContingentPhysicsLinkage->StepWorld(TickliteNow);
-		}
+	)
+	{
+		//whatever the game thread registered since last tick, before anything here looks a gun or an attribute up.
+		ContingentDispatchLinkage->TakeSimMappingChanges();
+		//ticklites calculate first. this used to run on its own thread, alongside the frame sim.
+		ContingentDispatchLinkage->ArtilleryTicklitesWorker_LockstepToWorldSim.Calculate();
+		currentIndexCabling = CablingControlStream->highestInput;
+		currentIndexBristlecone = BristleconeControlStream->highestInput;
+		TheCone::PacketElement current = 0;
+		bool RemoteInput = false;
+		RunStandardFrameSim(RemoteJitter, currentIndexCabling, SimTick++, current, RemoteInput);
+		/*
+		*
+		* Jolt will go here? No point in updating if we need to reconcile first.
+		* Note: We also have Iris performing intermittent state stomps to recover from more serious desyncs.
+		* Ultimately, rollback can never solve everything. The window's just get too wide.
+		*/
+		
+		sent = true;
+		TickliteNow = ContingentInputECSLinkage->Now(); // this updates ONCE PER CYCLE. ONCE. THIS IS INTENDED.
+		
+		ContingentDispatchLinkage->RunLocomotions();
+		//such a simple thing, after all this work.
+		ContingentPhysicsLinkage->StackUp();
+		//apply used to be triggered here and run alongside the step. run it first instead, so its forces make this step.
+		ContingentDispatchLinkage->ArtilleryTicklitesWorker_LockstepToWorldSim.Apply();
+		ContingentPhysicsLinkage->StepWorld(TickliteNow);
+		//contacts come off the step here, not whenever the game thread next ticks, so everything that listens for them
+		//runs on this lane and sees the tick the step belonged to.
+		ContingentPhysicsLinkage->BroadcastContactEvents();
+		ContingentDispatchLinkage->PublishTransformSnapshots();
+	}
 
-		//unlike cabling, we do our time keeping HERE. It may be worth switching cabling to also follow this.
-		//though if we end up using frameworks where the poll isn't free, we'll get dorked for doing it this way.
-		//Increment window is still used to ensure we have at least two milliseconds to run, though.
-		if ((LastIncrementWindow + Period) <= lsbTime)
+	//unlike cabling, we do our time keeping HERE. It may be worth switching cabling to also follow this.
+	//though if we end up using frameworks where the poll isn't free, we'll get dorked for doing it this way.
+	//Increment window is still used to ensure we have at least two milliseconds to run, though.
+	if ((LastIncrementWindow + Period) <= lsbTime)
+	{
+		LastIncrementWindow = lsbTime;
+		if ((seqNumber % SendHertzFactor) == 0)
 		{
-			LastIncrementWindow = lsbTime;
-			if ((seqNumber % sendHertzFactor) == 0)
-			{
-				sent = false;
-			}
-			++seqNumber;
+			sent = false;
 		}
-		std::this_thread::sleep_for(Step);
-		lsbTime = ContingentInputECSLinkage->Now();
+		++seqNumber;
 	}
-	timeEndPeriod(2);
-	UE_LOG(LogTemp, Display, TEXT("Artillery:BusyWorker: Run Ended."));
-	return 0;
-}
-
-void FArtilleryBusyWorker::Exit()
-{
-	UE_LOG(LogTemp, Display, TEXT("ARTILLERY OFFLINE."));
-	Cleanup();
+	lsbTime = ContingentInputECSLinkage->Now();
 }
 
 void FArtilleryBusyWorker::Stop()
 {
-	UE_LOG(LogTemp, Display, TEXT("Artillery:BusyWorker: Stopping Artillery thread."));
+	UE_LOG(LogTemp, Display, TEXT("ARTILLERY OFFLINE."));
 	Cleanup();
 }
 
@@ -0,0 +1,133 @@
+#include "FArtilleryWorkerPool.h"
+#include "FArtilleryBusyWorker.h"
+
+namespace
+{
+	const double PollSeconds = std::chrono::duration<double>(FArtilleryBusyWorker::PollStep).count();
+}
+
+FArtilleryWorkerPool& FArtilleryWorkerPool::Get()
+{
+	//one per process. that's the whole point of it.
+	static FArtilleryWorkerPool Pool;
+	return Pool;
+}
+
+FArtilleryWorkerPool::~FArtilleryWorkerPool()
+{
+	//every match should've been released by now. if one wasn't, don't leave a lane running into a dead world.
+	for (const TUniquePtr<FLane>& Lane : Lanes)
+	{
+		Lane->Thread->Kill(true);
+	}
+}
+
+void FArtilleryWorkerPool::GrowLanes()
+{
+	const int32 Wanted = FMath::Min(Hosted.Num(), FMath::Max(1, FPlatformMisc::NumberOfCores()));
+	while (Lanes.Num() < Wanted)
+	{
+		FLane* Lane = Lanes.Add_GetRef(MakeUnique<FLane>(*this)).Get();
+		Lane->Thread.Reset(FRunnableThread::Create(Lane, *FString::Printf(TEXT("ARTILLERY_LANE_%d"), LanesStarted++)));
+	}
+}
+
+void FArtilleryWorkerPool::Host(FArtilleryBusyWorker* Match)
+{
+	FScopeLock Hold(&PoolLock);
+	Hosted.Add(MakeShared<FHosted>(Match));
+	GrowLanes();
+	UE_LOG(LogTemp, Display, TEXT("Artillery:WorkerPool: hosting %d matches on %d lanes"), Hosted.Num(), Lanes.Num());
+}
+
+void FArtilleryWorkerPool::Release(FArtilleryBusyWorker* Match)
+{
+	TSharedPtr<FHosted> Leaving;
+	TArray<TUniquePtr<FLane>> Stopping;
+	{
+		FScopeLock Hold(&PoolLock);
+		const int32 Index = Hosted.IndexOfByPredicate([Match](const TSharedPtr<FHosted>& Each) { return Each->Match == Match; });
+		if (Index == INDEX_NONE)
+		{
+			return;
+		}
+		//out of the list first, so no lane can claim it from here on.
+		Leaving = Hosted[Index];
+		Hosted.RemoveAt(Index);
+		Cursor = Hosted.IsEmpty() ? 0 : Cursor % Hosted.Num();
+		//no more lanes than matches. the extra ones are told to stop now and joined below.
+		while (Lanes.Num() > Hosted.Num())
+		{
+			Lanes.Last()->bRunning = false;
+			Stopping.Add(Lanes.Pop(EAllowShrinking::No));
+		}
+	}
+	//neither of these holds the lock. a lane finishing its pass, or a stopping lane's last claim, might need it.
+	while (Leaving->InPump.load(std::memory_order_acquire))
+	{
+		FPlatformProcess::Yield();
+	}
+	for (const TUniquePtr<FLane>& Lane : Stopping)
+	{
+		Lane->Thread->WaitForCompletion();
+	}
+}
+
+TSharedPtr<FArtilleryWorkerPool::FHosted> FArtilleryWorkerPool::Claim()
+{
+	FScopeLock Hold(&PoolLock);
+	const double Now = FPlatformTime::Seconds();
+	const int32 Count = Hosted.Num();
+	for (int32 Step = 0; Step < Count; ++Step)
+	{
+		const int32 Index = (Cursor + Step) % Count;
+		FHosted& Candidate = *Hosted[Index];
+		if (Candidate.NextDue <= Now && !Candidate.InPump.exchange(true, std::memory_order_acquire))
+		{
+			Candidate.NextDue = Now + PollSeconds;
+			Cursor = (Index + 1) % Count;
+			return Hosted[Index];
+		}
+	}
+	return nullptr;
+}
+
+void FArtilleryWorkerPool::PumpClaimed(FHosted& Claimed)
+{
+	if (!Claimed.bBegun)
+	{
+		//on a lane, not the game thread, so the feed it's granted belongs to a thread that pumps.
+		//a match that fails to start is never pumped. it just gets skipped until it's released.
+		Claimed.bBegun = true;
+		Claimed.bStarted = Claimed.Match->Begin();
+		UE_CLOG(!Claimed.bStarted, LogTemp, Error, TEXT("Artillery:WorkerPool: a match failed to start and won't be pumped"));
+	}
+	if (Claimed.bStarted)
+	{
+		Claimed.Match->Pump();
+	}
+}
+
+uint32 FArtilleryWorkerPool::FLane::Run()
+{
+#if PLATFORM_WINDOWS
+	timeBeginPeriod(2);
+#endif
+	while (bRunning)
+	{
+		if (const TSharedPtr<FHosted> Claimed = Pool.Claim())
+		{
+			PumpClaimed(*Claimed);
+			Claimed->InPump.store(false, std::memory_order_release);
+		}
+		else
+		{
+			//nothing due, or everything due is on another lane.
+			std::this_thread::sleep_for(FArtilleryBusyWorker::PollStep);
+		}
+	}
+#if PLATFORM_WINDOWS
+	timeEndPeriod(2);
+#endif
+	return 0;
+}
@@ -0,0 +1,8 @@
+#include "FGunDefinitionBlob.h"
+
+FGunDefinitionBlob& FGunDefinitionBlob::Get()
+{
+	//one per process, so every world and module reads and reloads the same mapping.
+	static FGunDefinitionBlob Blob;
+	return Blob;
+}
@@ -0,0 +1,44 @@
+#include "FGunKey.h"
+
+//one table per process, not per module. see FGunDefinitionIds.
+//built on first use rather than at file scope. gun keys are made by other files' statics, FArtilleryGun's default for
+//one, and nothing orders those against ours.
+struct FGunDefinitionTable
+{
+	FRWLock Lock;
+	TArray<FString> Names;
+	TMap<FString, uint32> Indices;
+};
+
+static FGunDefinitionTable& GunDefinitions()
+{
+	static FGunDefinitionTable Table;
+	return Table;
+}
+
+uint32 FGunDefinitionIds::Intern(const FString& GunDefinitionID)
+{
+	FGunDefinitionTable& Table = GunDefinitions();
+	{
+		FReadScopeLock Read(Table.Lock);
+		if (const uint32* Found = Table.Indices.Find(GunDefinitionID))
+		{
+			return *Found;
+		}
+	}
+	FWriteScopeLock Write(Table.Lock);
+	if (const uint32* Found = Table.Indices.Find(GunDefinitionID))
+	{
+		return *Found;
+	}
+	const uint32 NewIndex = Table.Names.Add(GunDefinitionID);
+	Table.Indices.Add(GunDefinitionID, NewIndex);
+	return NewIndex;
+}
+
+FString FGunDefinitionIds::Resolve(uint32 Index)
+{
+	FGunDefinitionTable& Table = GunDefinitions();
+	FReadScopeLock Read(Table.Lock);
+	return Table.Names.IsValidIndex(Index) ? Table.Names[Index] : FString();
+}
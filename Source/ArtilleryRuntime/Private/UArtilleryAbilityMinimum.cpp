@@ -56,7 +56,7 @@ void UArtilleryPerActorAbilityMinimum::ActivateAbility(const FGameplayAbilitySpe
 
 	if (TriggerEventData)
 	{
-		K2_ActivateViaArtillery(*ActorInfo, *TriggerEventData, MyGunKey);
+		K2_ActivateViaArtillery(*ActorInfo, *TriggerEventData, GetActivatingGun(TriggerEventData));
 	}
 	else if (bHasBlueprintActivateFromEvent)
 	{
@@ -82,17 +82,34 @@ void UArtilleryPerActorAbilityMinimum::ActivateAbility(const FGameplayAbilitySpe
 	}
 }
 
+FGunKey UArtilleryPerActorAbilityMinimum::GetActivatingGun(const FGameplayEventData* TriggerEventData) const
+{
+	if (TriggerEventData)
+	{
+		for (int32 i = 0; i < TriggerEventData->TargetData.Num(); ++i)
+		{
+			const FGameplayAbilityTargetData* Data = TriggerEventData->TargetData.Get(i);
+			if (Data && Data->GetScriptStruct() == FArtilleryGunTargetData::StaticStruct())
+			{
+				return static_cast<const FArtilleryGunTargetData*>(Data)->Gun;
+			}
+		}
+	}
+	return MyGunKey;
+}
+
 void UArtilleryPerActorAbilityMinimum::PreActivate(const FGameplayAbilitySpecHandle Handle, const FGameplayAbilityActorInfo* ActorInfo, const FGameplayAbilityActivationInfo ActivationInfo, FOnGameplayAbilityEnded::FDelegate* OnGameplayAbilityEndedDelegate, const FGameplayEventData* TriggerEventData)
 {
 		//right now, we do EXACTLY AND ONLY what UGA does. This is going to get less and less true.
 		Super::PreActivate(Handle, ActorInfo, ActivationInfo, OnGameplayAbilityEndedDelegate, TriggerEventData);
+		ActivatingGun = GetActivatingGun(TriggerEventData);
 }
 
 void UArtilleryPerActorAbilityMinimum::EndAbility(const FGameplayAbilitySpecHandle Handle, const FGameplayAbilityActorInfo* ActorInfo, const FGameplayAbilityActivationInfo ActivationInfo, bool bReplicateEndAbility, bool bWasCancelled)
 {
 		Super::EndAbility(Handle, ActorInfo, ActivationInfo, bReplicateEndAbility, bWasCancelled);
 		FArtilleryStates HowDidItGo = bWasCancelled ? FArtilleryStates::Fired : FArtilleryStates::Canceled ;
-		GunBinder.Execute(HowDidItGo, AvailableDallyFrames, ActorInfo, ActivationInfo);
+		GunBinder.ExecuteIfBound(ActivatingGun, HowDidItGo, AvailableDallyFrames, ActorInfo, ActivationInfo);
 }
 
 bool UArtilleryPerActorAbilityMinimum::CommitAbility(const FGameplayAbilitySpecHandle Handle, const FGameplayAbilityActorInfo* ActorInfo, const FGameplayAbilityActivationInfo ActivationInfo, OUT FGameplayTagContainer* OptionalRelevantTags)
@@ -87,6 +87,12 @@ namespace Arty
 		TickliteCadence Cadence = TickliteCadence::Lite;
 		TicklitePhase RunGroup = TicklitePhase::Normal;
 		ArtilleryTime MadeStamp = 0;
+		//whatever this ticklite exists for. when the owner goes, so does the ticklite. see RetireTicklitesOwnedBy.
+		FSkeletonKey Owner;
+		//set by the worker when the owner's retired. retired ticklites don't run and don't get OnExpiration.
+		bool Retired = false;
+		//when the add was asked for, against retirements. see RequestRetireOwner.
+		uint64 RequestSerial = 0;
 	};
 	struct TicklitePrototype : TicklikeMemoryBlock
 	{
@@ -116,6 +122,16 @@ namespace Arty
 	typedef TArray<TPair<BristleTime,FGunKey>> EventBuffer;
 	typedef TTripleBuffer<EventBuffer> BufferedEvents;
 
+	//what the busy worker hands the game thread for a shot it already resolved. ammo, cooldown, all of that is done
+	//by the time one of these exists. the game thread just plays it.
+	struct FArtilleryFireCue
+	{
+		BristleTime Time;
+		FGunKey Gun;
+		bool Fired;
+	};
+	typedef TCircularQueue<FArtilleryFireCue> FireCueQueue;
+
 	//Ever see the motto of the old naval railgun project? I won't spoil it for you.
 	typedef FVector3d VelocityVec;
 	typedef TTuple<ArtilleryTime, FSkeletonKey, VelocityVec> VelocityEvent;
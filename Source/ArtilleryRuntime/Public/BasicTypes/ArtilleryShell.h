@@ -45,6 +45,8 @@ public:
 
 	BristleTime SentAt;
 	ArtilleryTime ReachedArtilleryAt;
+	//a guess at remote input that hadn't arrived when it was due. cleared when the real input confirms or replaces it.
+	bool Predicted = false;
 	bool RunAtLeastOnce = false; // if this is set, all artillery abilities spawned by running this input will be treated as having run at least once, and will not spawn cosmetic cues. Some animations may still play.
 	
 	//unpack as floats using the bristlecone packer logic. this is cross-machine deterministic.
@@ -8,6 +8,7 @@
 #include "Engine/DataTable.h"
 #include "AttributeSet.h"
 #include "Containers/CircularBuffer.h"
+#include <atomic>
 
 #include "ConservedAttribute.generated.h"
 /**
@@ -30,11 +31,47 @@ struct ARTILLERYRUNTIME_API FConservedAttributeData : public FGameplayAttributeD
 	};
 
 	virtual void SetCurrentValue(double NewValue) {
-		CurrentHistory[CurrentHistory.GetNextIndex(CurrentHead)] = CurrentValue;
+		CurrentHistory[CurrentHistory.GetNextIndex(CurrentHead)] = GetLiveValue();
 		CurrentValue = NewValue;
+		RegenStart = RegenClock ? RegenClock->load(std::memory_order_relaxed) : 0;
 		++CurrentHead;
 	};
 
+	//Regen is a line, not a tick. the stored value is where the line started, and the live value is worked out when asked:
+	//	min(cap, stored + rate * ticks since start)
+	//so an entity regenerating costs nothing until someone reads it, and the history only sees real changes.
+	//any set materializes the line and starts a new one from the set value.
+	//hides FGameplayAttributeData's version, so anything holding the conserved type sees regen.
+	float GetCurrentValue() const
+	{
+		return static_cast<float>(GetLiveValue());
+	}
+
+	double GetLiveValue() const
+	{
+		if (RegenRate == 0 || !RegenClock)
+		{
+			return CurrentValue;
+		}
+		const uint64 Elapsed = RegenClock->load(std::memory_order_relaxed) - RegenStart;
+		return FMath::Min(RegenCap, CurrentValue + RegenRate * static_cast<double>(Elapsed));
+	}
+
+	//Sim thread. a rate of 0 stops regen where it is. not a history event. the clock is the match's, off its ticklites
+	//worker, which moves it once per tick after apply. every match ticks on its own, so there's no one clock to share.
+	void SetRegen(double Rate, double Cap, const TSharedPtr<std::atomic<uint64>>& Clock)
+	{
+		if (Rate == RegenRate && Cap == RegenCap && Clock == RegenClock)
+		{
+			return;
+		}
+		CurrentValue = GetLiveValue();
+		RegenClock = Clock;
+		RegenStart = RegenClock ? RegenClock->load(std::memory_order_relaxed) : 0;
+		RegenRate = Rate;
+		RegenCap = Cap;
+	}
+
 	virtual void SetRemoteValue(float NewValue) {
 		SetRemoteValue(static_cast<double>(NewValue));
 	};
@@ -55,17 +92,21 @@ struct ARTILLERYRUNTIME_API FConservedAttributeData : public FGameplayAttributeD
 	};
 	double operator*(FConservedAttributeData const& rhs) 
 	{ 
-		return CurrentValue * rhs.CurrentValue; // this is a double op.
+		return GetLiveValue() * rhs.GetLiveValue(); // this is a double op.
 	};
 	double operator*(int const& rhs) 
 	{ 
-		return CurrentValue * rhs; // this is a double op.
+		return GetLiveValue() * rhs; // this is a double op.
 	}
 	double operator*(uint64 const& rhs) 
 	{ 
-		return CurrentValue * rhs; // this is a double op.
+		return GetLiveValue() * rhs; // this is a double op.
 	}
 protected:
+	TSharedPtr<std::atomic<uint64>> RegenClock;
+	double RegenRate = 0;
+	double RegenCap = 0;
+	uint64 RegenStart = 0;
 	uint64_t BaseHead = 0;
 	uint64_t CurrentHead = 0;
 	uint64_t RemoteHead = 0;
@@ -0,0 +1,177 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ArtilleryShell.h"
+#include "FCablePackedInput.h"
+
+//A read-only window over a run of a conserved input stream's history, without copying it. the history is a ring, so a
+//run can wrap; the view is at most two spans, older first. it's only as good as the ring underneath it, same as peek.
+//don't hold one across ticks.
+struct FArtilleryInputView
+{
+	TConstArrayView<FArtilleryShell> Older;
+	TConstArrayView<FArtilleryShell> Newer;
+	uint64 FirstInput = 0;
+
+	int32 Num() const
+	{
+		return Older.Num() + Newer.Num();
+	}
+
+	bool IsEmpty() const
+	{
+		return Num() == 0;
+	}
+
+	//0 is the oldest input in the view.
+	const FArtilleryShell& operator[](int32 Index) const
+	{
+		return Index < Older.Num() ? Older[Index] : Newer[Index - Older.Num()];
+	}
+
+	//Visit(const FArtilleryShell&), oldest first.
+	template <typename Visitor>
+	void ForEach(Visitor&& Visit) const
+	{
+		for (const FArtilleryShell& Shell : Older)
+		{
+			Visit(Shell);
+		}
+		for (const FArtilleryShell& Shell : Newer)
+		{
+			Visit(Shell);
+		}
+	}
+};
+
+//N shells unpacked at once, one array per field, oldest first. the field unpack is shifts and masks over a flat run of
+//uint64s, which the compiler vectorizes. the sticks then go through a table built from the cabling packer itself, so
+//the floats are exactly what FArtilleryShell::GetStickLeftX and friends would have given you, just without the calls.
+struct FArtilleryInputBatch
+{
+	TArray<float> LeftX;
+	TArray<float> LeftY;
+	TArray<float> RightX;
+	TArray<float> RightY;
+	//same bit order as FArtilleryShell::GetButtonsAndEventsFlat, split.
+	TArray<uint32> Buttons;
+	TArray<uint32> Events;
+
+	int32 Num() const
+	{
+		return Buttons.Num();
+	}
+
+	//reuses whatever the batch already allocated.
+	void Decode(const FArtilleryInputView& View)
+	{
+		const int32 Count = View.Num();
+		Packed.SetNumUninitialized(Count, EAllowShrinking::No);
+		int32 At = 0;
+		View.ForEach([this, &At](const FArtilleryShell& Shell)
+		{
+			Packed[At++] = Shell.MyInputActions;
+		});
+		Decode(Packed);
+	}
+
+	void Decode(TConstArrayView<uint64> Inputs)
+	{
+		const int32 Count = Inputs.Num();
+		LeftX.SetNumUninitialized(Count, EAllowShrinking::No);
+		LeftY.SetNumUninitialized(Count, EAllowShrinking::No);
+		RightX.SetNumUninitialized(Count, EAllowShrinking::No);
+		RightY.SetNumUninitialized(Count, EAllowShrinking::No);
+		Buttons.SetNumUninitialized(Count, EAllowShrinking::No);
+		Events.SetNumUninitialized(Count, EAllowShrinking::No);
+		StickFields.SetNumUninitialized(Count * 4, EAllowShrinking::No);
+		const uint64* RESTRICT In = Inputs.GetData();
+		uint16* RESTRICT Fields = StickFields.GetData();
+		uint32* RESTRICT OutButtons = Buttons.GetData();
+		uint32* RESTRICT OutEvents = Events.GetData();
+		//MSB[sticks][buttons][events]LSB. see ArtilleryShell.cpp.
+		for (int32 i = 0; i < Count; ++i)
+		{
+			const uint64 Bits = In[i];
+			Fields[i] = static_cast<uint16>(Bits >> 53);
+			Fields[Count + i] = static_cast<uint16>((Bits >> 42) & StickMask);
+			Fields[Count * 2 + i] = static_cast<uint16>((Bits >> 31) & StickMask);
+			Fields[Count * 3 + i] = static_cast<uint16>((Bits >> 20) & StickMask);
+			OutButtons[i] = static_cast<uint32>((Bits >> 6) & 0b11111111111111);
+			OutEvents[i] = static_cast<uint32>(Bits & 0b111111);
+		}
+		const float* Table = StickTable();
+		for (int32 i = 0; i < Count; ++i)
+		{
+			LeftX[i] = Table[Fields[i]];
+			LeftY[i] = Table[Fields[Count + i]];
+			RightX[i] = Table[Fields[Count * 2 + i]];
+			RightY[i] = Table[Fields[Count * 3 + i]];
+		}
+	}
+
+	//buttons down on every input in the batch. a hold is this against the mask you care about.
+	uint32 ButtonsHeldThroughout() const
+	{
+		uint32 Held = Buttons.IsEmpty() ? 0 : ~0u;
+		for (const uint32 Pressed : Buttons)
+		{
+			Held &= Pressed;
+		}
+		return Held;
+	}
+
+	//buttons down on any input in the batch.
+	uint32 ButtonsSeen() const
+	{
+		uint32 Seen = 0;
+		for (const uint32 Pressed : Buttons)
+		{
+			Seen |= Pressed;
+		}
+		return Seen;
+	}
+
+	uint32 EventsSeen() const
+	{
+		uint32 Seen = 0;
+		for (const uint32 Fired : Events)
+		{
+			Seen |= Fired;
+		}
+		return Seen;
+	}
+
+	//largest squared deflection of the left stick in the batch. a flick is this crossing a threshold inside the sweep back.
+	float MaxLeftStickSquared() const
+	{
+		float Max = 0;
+		for (int32 i = 0; i < LeftX.Num(); ++i)
+		{
+			Max = FMath::Max(Max, LeftX[i] * LeftX[i] + LeftY[i] * LeftY[i]);
+		}
+		return Max;
+	}
+
+private:
+	static constexpr uint64 StickMask = 0b11111111111;
+
+	//every 11 bit stick value, unpacked once by the packer. 8k, and it never changes.
+	static const float* StickTable()
+	{
+		static const TArray<float> Table = []()
+		{
+			TArray<float> Built;
+			Built.SetNumUninitialized(StickMask + 1);
+			for (uint32 Field = 0; Field <= StickMask; ++Field)
+			{
+				Built[Field] = FCableInputPacker::UnpackStick(Field);
+			}
+			return Built;
+		}();
+		return Table.GetData();
+	}
+
+	TArray<uint64> Packed;
+	TArray<uint16> StickFields;
+};
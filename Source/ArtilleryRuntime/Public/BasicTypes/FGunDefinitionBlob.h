@@ -0,0 +1,297 @@
+#pragma once
+#include "CoreMinimal.h"
+#include "CoreTypes.h"
+#include "HAL/PlatformFileManager.h"
+#include "Async/MappedFileHandle.h"
+#include "Misc/Paths.h"
+#include "Misc/FileHelper.h"
+#include "FGunKey.h"
+#include "FGunDefinitionRow.h"
+
+//The compiled form of the gun definitions. One file, fixed layout, no parsing:
+//	header | records | strings
+//records are read straight out of the mapping. strings are utf8, null terminated, and only touched when something
+//actually needs a name or an ability path, which is never on the fire path.
+//bump the version any time the record layout changes. old blobs get refused, not misread.
+namespace ArtilleryGunBlob
+{
+	static constexpr uint32 Magic = 0x4E554741; // "AGUN"
+	static constexpr uint32 Version = 1;
+	static constexpr uint32 NoString = MAX_uint32;
+
+	//abilities in the order the gun holds them.
+	enum EAbilitySlot : uint8
+	{
+		PreFire,
+		PreFireCosmetic,
+		Fire,
+		FireCosmetic,
+		PostFire,
+		PostFireCosmetic,
+		FailureCosmetic,
+		SlotCount
+	};
+}
+
+struct FGunDefinitionBlobHeader
+{
+	uint32 Magic;
+	uint32 Version;
+	uint32 RecordSize;
+	uint32 RecordCount;
+	uint32 StringsOffset;
+	uint32 StringsSize;
+};
+
+struct FGunDefinitionRecord
+{
+	//offsets into the string block.
+	uint32 GunDefinitionId;
+	uint32 Abilities[ArtilleryGunBlob::SlotCount];
+	int32 BaseDamage;
+	int32 BaseRange;
+	int32 BaseRateOfFire;
+	int32 BaseRecoil;
+	int32 IntendedRegistrationPattern;
+	int32 PrewarmCount;
+};
+static_assert(std::is_trivially_copyable_v<FGunDefinitionRecord>, "gun records are read straight out of the mapping");
+static_assert(sizeof(FGunDefinitionBlobHeader) % alignof(FGunDefinitionRecord) == 0, "records follow the header unpadded");
+
+class ARTILLERYRUNTIME_API FGunDefinitionBlob
+{
+public:
+	//one mapping for the process, shared by every world. game thread only, like everything else in here.
+	static FGunDefinitionBlob& Get();
+
+	FGunDefinitionBlob() = default;
+	FGunDefinitionBlob(const FGunDefinitionBlob&) = delete;
+	FGunDefinitionBlob& operator=(const FGunDefinitionBlob&) = delete;
+	~FGunDefinitionBlob()
+	{
+		Close();
+	}
+
+	static FString DefaultPath()
+	{
+		return FPaths::Combine(FPaths::ProjectPluginsDir(), TEXT("Artillery"), TEXT("Data"), TEXT("GunData"), TEXT("GunDefinitions.artgun"));
+	}
+
+	//the compiler writes here, never over a live mapping. see SwapInPending.
+	static FString PendingPath(const FString& Path)
+	{
+		return Path + TEXT(".pending");
+	}
+
+	bool IsLoaded() const
+	{
+		return Records != nullptr;
+	}
+
+	//maps the file and indexes it by interned definition id. interning happens here, once, so lookups after are flat.
+	bool Open(const FString& Path)
+	{
+		Close();
+		IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+		Handle.Reset(PlatformFile.OpenMapped(*Path));
+		if (!Handle.IsValid())
+		{
+			return false;
+		}
+		Region.Reset(Handle->MapRegion(0, Handle->GetFileSize(), true));
+		if (!Region.IsValid())
+		{
+			Close();
+			return false;
+		}
+		const uint8* Base = Region->GetMappedPtr();
+		const int64 Size = Region->GetMappedSize();
+		if (Size < static_cast<int64>(sizeof(FGunDefinitionBlobHeader)))
+		{
+			UE_LOG(LogTemp, Error, TEXT("GunDefinitionBlob: %s is too small to be a gun blob."), *Path);
+			Close();
+			return false;
+		}
+		const FGunDefinitionBlobHeader* Header = reinterpret_cast<const FGunDefinitionBlobHeader*>(Base);
+		const int64 RecordsEnd = sizeof(FGunDefinitionBlobHeader) + static_cast<int64>(Header->RecordCount) * sizeof(FGunDefinitionRecord);
+		if (Header->Magic != ArtilleryGunBlob::Magic
+			|| Header->Version != ArtilleryGunBlob::Version
+			|| Header->RecordSize != sizeof(FGunDefinitionRecord)
+			|| RecordsEnd > Header->StringsOffset
+			|| static_cast<int64>(Header->StringsOffset) + Header->StringsSize > Size
+			|| (Header->StringsSize > 0 && Base[Header->StringsOffset + Header->StringsSize - 1] != 0))
+		{
+			UE_LOG(LogTemp, Error, TEXT("GunDefinitionBlob: %s is the wrong version or is damaged. Recompile the gun definitions."), *Path);
+			Close();
+			return false;
+		}
+
+		Records = reinterpret_cast<const FGunDefinitionRecord*>(Base + sizeof(FGunDefinitionBlobHeader));
+		RecordCount = Header->RecordCount;
+		Strings = reinterpret_cast<const UTF8CHAR*>(Base + Header->StringsOffset);
+		StringsSize = Header->StringsSize;
+		for (uint32 i = 0; i < RecordCount; ++i)
+		{
+			const uint32 Index = FGunDefinitionIds::Intern(GetString(Records[i].GunDefinitionId));
+			while (static_cast<uint32>(RecordByDefinition.Num()) <= Index)
+			{
+				RecordByDefinition.Add(INDEX_NONE);
+			}
+			RecordByDefinition[Index] = i;
+		}
+		return true;
+	}
+
+	void Close()
+	{
+		Records = nullptr;
+		RecordCount = 0;
+		Strings = nullptr;
+		StringsSize = 0;
+		RecordByDefinition.Reset();
+		Region.Reset();
+		Handle.Reset();
+	}
+
+	//O(1). null if the blob doesn't know this definition.
+	const FGunDefinitionRecord* Find(uint32 GunDefinitionIndex) const
+	{
+		if (!RecordByDefinition.IsValidIndex(GunDefinitionIndex) || RecordByDefinition[GunDefinitionIndex] == INDEX_NONE)
+		{
+			return nullptr;
+		}
+		return &Records[RecordByDefinition[GunDefinitionIndex]];
+	}
+
+	TConstArrayView<FGunDefinitionRecord> GetRecords() const
+	{
+		return TConstArrayView<FGunDefinitionRecord>(Records, RecordCount);
+	}
+
+	FString GetString(uint32 Offset) const
+	{
+		if (Offset == ArtilleryGunBlob::NoString || Offset >= StringsSize)
+		{
+			return FString();
+		}
+		return FString(UTF8_TO_TCHAR(reinterpret_cast<const ANSICHAR*>(Strings + Offset)));
+	}
+
+	//dev only. if a freshly compiled blob is waiting next to ours, let go of the mapping, move it into place, and remap.
+	//the mapping has to go first or windows won't let us replace the file. the live blob is moved aside rather than
+	//deleted, and only deleted once the new one has mapped, so a failed swap leaves us where we were.
+	bool SwapInPending(const FString& Path)
+	{
+		IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+		const FString Pending = PendingPath(Path);
+		if (!PlatformFile.FileExists(*Pending))
+		{
+			return false;
+		}
+		const FString Retired = Path + TEXT(".old");
+		const bool HadLive = PlatformFile.FileExists(*Path);
+		Close();
+		PlatformFile.DeleteFile(*Retired);
+		if (HadLive && !PlatformFile.MoveFile(*Retired, *Path))
+		{
+			UE_LOG(LogTemp, Error, TEXT("GunDefinitionBlob: couldn't move %s aside, keeping it."), *Path);
+			Open(Path);
+			return false;
+		}
+		if (!PlatformFile.MoveFile(*Path, *Pending))
+		{
+			UE_LOG(LogTemp, Error, TEXT("GunDefinitionBlob: couldn't move %s into place."), *Pending);
+			if (HadLive)
+			{
+				PlatformFile.MoveFile(*Path, *Retired);
+				Open(Path);
+			}
+			return false;
+		}
+		if (!Open(Path))
+		{
+			//Open has already said what was wrong with it. back to the old one.
+			if (HadLive)
+			{
+				PlatformFile.DeleteFile(*Path);
+				PlatformFile.MoveFile(*Path, *Retired);
+				Open(Path);
+			}
+			return false;
+		}
+		PlatformFile.DeleteFile(*Retired);
+		return true;
+	}
+
+#if WITH_EDITOR
+	//the build step. rows in, blob out. the runtime never sees the table once this has run.
+	static bool Compile(const TArray<const FGunDefinitionRow*>& Rows, const FString& OutPath)
+	{
+		TArray<uint8> StringBlock;
+		TMap<FString, uint32> Pooled;
+		auto AddString = [&StringBlock, &Pooled](const FString& Value) -> uint32
+		{
+			if (Value.IsEmpty())
+			{
+				return ArtilleryGunBlob::NoString;
+			}
+			if (const uint32* Found = Pooled.Find(Value))
+			{
+				return *Found;
+			}
+			const uint32 Offset = StringBlock.Num();
+			const FTCHARToUTF8 Converted(*Value);
+			StringBlock.Append(reinterpret_cast<const uint8*>(Converted.Get()), Converted.Length());
+			StringBlock.Add(0);
+			Pooled.Add(Value, Offset);
+			return Offset;
+		};
+
+		TArray<FGunDefinitionRecord> Records;
+		Records.Reserve(Rows.Num());
+		for (const FGunDefinitionRow* Row : Rows)
+		{
+			FGunDefinitionRecord& Record = Records.AddZeroed_GetRef();
+			Record.GunDefinitionId = AddString(Row->GunDefinitionId);
+			Record.Abilities[ArtilleryGunBlob::PreFire] = AddString(Row->PreFireAbility);
+			Record.Abilities[ArtilleryGunBlob::PreFireCosmetic] = AddString(Row->PreFireCosmeticAbility);
+			Record.Abilities[ArtilleryGunBlob::Fire] = AddString(Row->FireAbility);
+			Record.Abilities[ArtilleryGunBlob::FireCosmetic] = AddString(Row->FireCosmeticAbility);
+			Record.Abilities[ArtilleryGunBlob::PostFire] = AddString(Row->PostFireAbility);
+			Record.Abilities[ArtilleryGunBlob::PostFireCosmetic] = AddString(Row->PostFireCosmeticAbility);
+			Record.Abilities[ArtilleryGunBlob::FailureCosmetic] = AddString(Row->FailureCosmeticAbility);
+			Record.BaseDamage = Row->BaseDamage;
+			Record.BaseRange = Row->BaseRange;
+			Record.BaseRateOfFire = Row->BaseRateOfFire;
+			Record.BaseRecoil = Row->BaseRecoil;
+			Record.IntendedRegistrationPattern = Row->IntendedRegistrationPattern;
+			Record.PrewarmCount = Row->PrewarmCount;
+		}
+
+		FGunDefinitionBlobHeader Header;
+		Header.Magic = ArtilleryGunBlob::Magic;
+		Header.Version = ArtilleryGunBlob::Version;
+		Header.RecordSize = sizeof(FGunDefinitionRecord);
+		Header.RecordCount = Records.Num();
+		Header.StringsOffset = sizeof(FGunDefinitionBlobHeader) + Records.Num() * sizeof(FGunDefinitionRecord);
+		Header.StringsSize = StringBlock.Num();
+
+		TArray<uint8> Out;
+		Out.Reserve(Header.StringsOffset + Header.StringsSize);
+		Out.Append(reinterpret_cast<const uint8*>(&Header), sizeof(Header));
+		Out.Append(reinterpret_cast<const uint8*>(Records.GetData()), Records.Num() * sizeof(FGunDefinitionRecord));
+		Out.Append(StringBlock);
+		return FFileHelper::SaveArrayToFile(Out, *OutPath);
+	}
+#endif
+
+private:
+	TUniquePtr<IMappedFileHandle> Handle;
+	TUniquePtr<IMappedFileRegion> Region;
+	const FGunDefinitionRecord* Records = nullptr;
+	uint32 RecordCount = 0;
+	const UTF8CHAR* Strings = nullptr;
+	uint32 StringsSize = 0;
+	//interned definition index -> record. INDEX_NONE where the blob has no such gun.
+	TArray<int32> RecordByDefinition;
+};
@@ -53,4 +53,8 @@ struct FGunDefinitionRow : public FTableRowBase
 	//Unsure at this point in implementation if this value will always be respected.
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category=GunDefinition)
 	int32 IntendedRegistrationPattern;
+
+	//how many of this gun to build at level load so equips and respawns never allocate. 0 means build on demand.
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category=GunDefinition)
+	int32 PrewarmCount = 0;
 };
@@ -11,9 +11,41 @@
 #include "AttributeSet.h"
 #include <bitset>
 #include "Containers/CircularBuffer.h"
+#include "Misc/ScopeRWLock.h"
+#include <type_traits>
 #include "FGunKey.generated.h"
 
 
+//Every gun definition id we've seen, interned once. Indices are dense and never reused for the life of the process.
+//interning takes a lock, so do it when guns are made, not when they fire. Resolve is for logs and pooling.
+//the table lives in FGunKey.cpp, so every module that links us shares the one table and agrees on the indices. it's a
+//function local there, like FGunDefinitionBlob::Get, because gun keys get made during static init.
+class ARTILLERYRUNTIME_API FGunDefinitionIds
+{
+public:
+	static uint32 Intern(const FString& GunDefinitionID);
+	static FString Resolve(uint32 Index);
+};
+
+//everything a gun key takes from its definition. work it out once, at load, and keys can be made from it without a
+//lock or a string. see UArtilleryDispatch::GetGun.
+struct FGunDefinitionKeyParts
+{
+	uint32 Index = MAX_uint32;
+	uint32 NameHash = 0;
+	FName Name;
+
+	FGunDefinitionKeyParts()
+	{
+	}
+	explicit FGunDefinitionKeyParts(const FString& GunDefinitionID) :
+	Index(FGunDefinitionIds::Intern(GunDefinitionID)), NameHash(GetTypeHash(GunDefinitionID)), Name(*GunDefinitionID)
+	{
+	}
+};
+
+//Flat and trivially copyable. the name is interned and the skeleton key forged once, on construction, so the sim never
+//hashes anything to use one. the FName is there for blueprint and the editor, nothing in the sim compares on it.
 USTRUCT(BlueprintType)
 struct FGunKey
 {
@@ -22,28 +54,44 @@ public:
 	//TODO: this needs to be removed. we should never allow a default gunkey.
 	FGunKey()
 	{}
-	FGunKey(FString Name, uint64_t id):
-	GunDefinitionID(Name), GunInstanceID(id)
+	FGunKey(const FString& Name, uint64_t id): FGunKey(FGunDefinitionKeyParts(Name), id)
+	{
+	}
+	FGunKey(const FGunDefinitionKeyParts& Definition, uint64_t id):
+	GunInstanceID(id),
+	Forged(FORGE_SKELETON_KEY(Definition.NameHash + GetTypeHash(id), SKELLY::SFIX_ART_GUNS)),
+	GunDefinitionIndex(Definition.Index),
+	GunDefinitionName(Definition.Name)
 	{
 	}
-	UPROPERTY(BlueprintReadOnly)
-	FString GunDefinitionID; //this will need to be human searchable
 	//FUN STORY: BLUEPRINT CAN'T USE UINT64.
-	uint64 GunInstanceID;
+	uint64 GunInstanceID = 0;
+	//what this turns into as an object key. only ever set by the constructor.
+	FSkeletonKey Forged;
+	uint32 GunDefinitionIndex = MAX_uint32;
+	UPROPERTY(BlueprintReadOnly, Category = "Gun")
+	FName GunDefinitionName; //this will need to be human searchable
+
+	FString GetGunDefinitionID() const
+	{
+		return GunDefinitionName.ToString();
+	}
 	//while actor key has a different behavior, gunkey only applies the mask when switching up to objectkey.
 	//this is because those types are interchangeable for legacy reasons, which I intend to eliminate.
 	operator FSkeletonKey() const
 	{
-		return FSkeletonKey(FORGE_SKELETON_KEY(GetTypeHash(GunDefinitionID) + GetTypeHash(GunInstanceID), SKELLY::SFIX_ART_GUNS));
+		return Forged;
 	}
 	friend uint32 GetTypeHash(const FGunKey& Other)
 	{
 		// it's probably fine!
-		return GetTypeHash(Other.GunDefinitionID) + GetTypeHash(Other.GunInstanceID);
+		return GetTypeHash(Other.Forged);
 	}
 };
+//instance id, forged key, index, and the FName blueprint wants. 32 with an editor FName, less without.
+static_assert(sizeof(FGunKey) <= 32 && std::is_trivially_copyable_v<FGunKey>, "gunkeys go through the triple buffers by value. keep them small and flat.");
 static bool operator==(FGunKey const& lhs, FGunKey const& rhs) {
-	return (lhs.GunDefinitionID == rhs.GunDefinitionID) && (lhs.GunInstanceID == rhs.GunInstanceID);
+	return (lhs.GunDefinitionIndex == rhs.GunDefinitionIndex) && (lhs.GunInstanceID == rhs.GunInstanceID);
 }
 //when sorted, gunkeys follow their instantiation order!
 static bool operator<(FGunKey const& lhs, FGunKey const& rhs) {
@@ -0,0 +1,256 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ArtilleryShell.h"
+#include <atomic>
+#include <optional>
+
+//The older end of a conserved input stream's history. by the time an input gets here it's never going to change, and
+//most of it is the busy worker repeating the last input because nothing new came in, so it's stored as runs: one packed
+//input plus where the timestamps started and how far they step each input. a run only breaks when the input changes or
+//a timestamp stops stepping evenly. a guess still waiting on its real input breaks a run too, so it stays marked.
+//
+//runs are numbered oldest first, and lookups binary search their first inputs, which are sorted because inputs only
+//ever arrive in order. a run holds at least one input, so room for as many runs as the window has inputs always holds
+//the whole window, however busy the input gets. that room is almost never needed, so it isn't paid for up front.
+//runs live in chunks of RunsPerChunk, found through a fixed table, and a chunk is only allocated the first time the
+//live runs need one more than they've ever had. runs that end before the window retire on their own, and a chunk they
+//have all left goes on a free list for the next runs to come through, so a quiet stream holds a chunk or two, not the
+//whole window's worth. chunks are only freed with the log, which is what lets a reader touch one that just got recycled.
+//
+//single writer (the busy worker), any number of readers (the game thread, abilities). Begin and End are published with
+//release and read with acquire. a run's first input, actions, and flags never change once End covers it. the newest
+//run still grows, but only through its atomics, and its length is stored last, so a reader sees either the old run or
+//the longer one, never half of either. the only slots ever rewritten are ones the writer has already moved Begin past.
+//a reader that got lapped while it looked finds that out from Begin and gets nothing, same as if it asked for an input
+//that had already aged out.
+class FInputColdLog
+{
+public:
+	typedef decltype(FArtilleryShell::SentAt) SentTime;
+	typedef decltype(FArtilleryShell::ReachedArtilleryAt) ReachedTime;
+
+	static constexpr uint32 RunsPerChunk = 64;
+
+	//MaxRuns is the most runs ever live at once. runs that end more than InputWindow inputs behind the newest retire.
+	FInputColdLog(int32 MaxRuns, uint64 InInputWindow)
+		: Capacity(FMath::DivideAndRoundUp<uint64>(MaxRuns, RunsPerChunk) * RunsPerChunk)
+		, ChunkSlots(static_cast<uint32>(Capacity / RunsPerChunk) + 2)
+		, Chunks(MakeUnique<std::atomic<FRunChunk*>[]>(ChunkSlots))
+		, InputWindow(InInputWindow)
+	{
+	}
+
+	FInputColdLog(const FInputColdLog&) = delete;
+	FInputColdLog& operator=(const FInputColdLog&) = delete;
+
+	//busy worker only. inputs have to come in order, with no gaps.
+	void Append(uint64 Input, const FArtilleryShell& Shell)
+	{
+		const uint64 Newest = End.load(std::memory_order_relaxed);
+		RetireAged(Input, Newest);
+		const uint64 Oldest = Begin.load(std::memory_order_relaxed);
+		if (Newest > Oldest && Slot(Newest - 1).Extend(Shell))
+		{
+			return;
+		}
+		if (Newest - Oldest == Capacity)
+		{
+			RetireTo(Oldest + 1);
+		}
+		if (Newest % RunsPerChunk == 0)
+		{
+			//the table slot this takes last held a chunk that retired at least a full table ago.
+			Chunks[(Newest / RunsPerChunk) % ChunkSlots].store(TakeChunk(), std::memory_order_release);
+		}
+		Slot(Newest).Start(Input, Shell);
+		End.store(Newest + 1, std::memory_order_release);
+	}
+
+	bool IsEmpty() const
+	{
+		return End.load(std::memory_order_acquire) == Begin.load(std::memory_order_acquire);
+	}
+
+	std::optional<FArtilleryShell> Find(uint64 Input) const
+	{
+		const uint64 Newest = End.load(std::memory_order_acquire);
+		const uint64 Oldest = Begin.load(std::memory_order_acquire);
+		if (Newest == Oldest || Input < Slot(Oldest).FirstInput)
+		{
+			return std::nullopt;
+		}
+		//last run starting at or before the input.
+		uint64 Low = Oldest;
+		uint64 High = Newest;
+		while (High - Low > 1)
+		{
+			const uint64 Mid = Low + (High - Low) / 2;
+			if (Slot(Mid).FirstInput <= Input)
+			{
+				Low = Mid;
+			}
+			else
+			{
+				High = Mid;
+			}
+		}
+		const FRun& Run = Slot(Low);
+		const uint64 Offset = Input - Run.FirstInput;
+		const uint32 Length = Run.Length.load(std::memory_order_acquire);
+		std::optional<FArtilleryShell> Found = Offset < Length ? std::optional<FArtilleryShell>(Run.Expand(Offset)) : std::nullopt;
+		//a rewritten slot only ever pulls the search lower, so if ours is still live, everything we read was real.
+		std::atomic_thread_fence(std::memory_order_acquire);
+		if (Begin.load(std::memory_order_relaxed) > Low)
+		{
+			return std::nullopt;
+		}
+		return Found;
+	}
+
+	//how many runs are holding the history right now. for stats.
+	int32 NumRuns() const
+	{
+		return static_cast<int32>(End.load(std::memory_order_acquire) - Begin.load(std::memory_order_acquire));
+	}
+
+	//what the log is actually holding on to. busy worker only, for stats.
+	SIZE_T GetAllocatedSize() const
+	{
+		return OwnedChunks.Num() * sizeof(FRunChunk) + ChunkSlots * sizeof(std::atomic<FRunChunk*>);
+	}
+
+private:
+	struct FRun
+	{
+		//busy worker, before End covers the slot.
+		void Start(uint64 Input, const FArtilleryShell& Shell)
+		{
+			FirstInput = Input;
+			Actions = Shell.MyInputActions;
+			FirstSent = Shell.SentAt;
+			FirstReached = Shell.ReachedArtilleryAt;
+			RunAtLeastOnce = Shell.RunAtLeastOnce;
+			Predicted = Shell.Predicted;
+			SentStride.store(0, std::memory_order_relaxed);
+			ReachedStride.store(0, std::memory_order_relaxed);
+			Length.store(1, std::memory_order_relaxed);
+		}
+
+		//busy worker. the second input in a run sets the strides. after that, everything has to match them.
+		bool Extend(const FArtilleryShell& Shell)
+		{
+			if (Shell.MyInputActions != Actions || Shell.RunAtLeastOnce != RunAtLeastOnce || Shell.Predicted != Predicted)
+			{
+				return false;
+			}
+			const uint32 Current = Length.load(std::memory_order_relaxed);
+			const int64 SentStep = static_cast<int64>(Shell.SentAt) - static_cast<int64>(FirstSent);
+			const int64 ReachedStep = static_cast<int64>(Shell.ReachedArtilleryAt) - static_cast<int64>(FirstReached);
+			if (Current == 1)
+			{
+				//nobody can be expanding past offset 0 yet, so the strides can land before the length does.
+				SentStride.store(SentStep, std::memory_order_relaxed);
+				ReachedStride.store(ReachedStep, std::memory_order_relaxed);
+			}
+			else if (SentStep != SentStride.load(std::memory_order_relaxed) * Current
+				|| ReachedStep != ReachedStride.load(std::memory_order_relaxed) * Current)
+			{
+				return false;
+			}
+			Length.store(Current + 1, std::memory_order_release);
+			return true;
+		}
+
+		FArtilleryShell Expand(uint64 Offset) const
+		{
+			FArtilleryShell Shell;
+			Shell.MyInputActions = Actions;
+			Shell.SentAt = static_cast<SentTime>(static_cast<int64>(FirstSent) + SentStride.load(std::memory_order_relaxed) * static_cast<int64>(Offset));
+			Shell.ReachedArtilleryAt = static_cast<ReachedTime>(static_cast<int64>(FirstReached) + ReachedStride.load(std::memory_order_relaxed) * static_cast<int64>(Offset));
+			Shell.RunAtLeastOnce = RunAtLeastOnce;
+			Shell.Predicted = Predicted;
+			return Shell;
+		}
+
+		uint64 FirstInput = 0;
+		uint64 Actions = 0;
+		SentTime FirstSent = 0;
+		ReachedTime FirstReached = 0;
+		std::atomic<int64> SentStride = 0;
+		std::atomic<int64> ReachedStride = 0;
+		std::atomic<uint32> Length = 1;
+		bool RunAtLeastOnce = false;
+		bool Predicted = false;
+	};
+
+	struct FRunChunk
+	{
+		FRun Runs[RunsPerChunk];
+	};
+
+	//indices only ever count up. the chunk table wraps them. every run from Begin to End is in a chunk the table points
+	//at, so a reader that loaded End never finds an empty slot, only, at worst, a recycled chunk Begin will own up to.
+	FRun& Slot(uint64 Index) const
+	{
+		return Chunks[(Index / RunsPerChunk) % ChunkSlots].load(std::memory_order_acquire)->Runs[Index % RunsPerChunk];
+	}
+
+	//readers stop two seconds short of the window, so a run that ended before it is no use to anyone. never the newest
+	//run though. it's the one still growing, and keeping it means the log never goes empty between inputs.
+	void RetireAged(uint64 Input, uint64 Newest)
+	{
+		if (Input <= InputWindow)
+		{
+			return;
+		}
+		const uint64 Cutoff = Input - InputWindow;
+		uint64 Oldest = Begin.load(std::memory_order_relaxed);
+		while (Oldest + 1 < Newest)
+		{
+			const FRun& Run = Slot(Oldest);
+			if (Run.FirstInput + Run.Length.load(std::memory_order_relaxed) > Cutoff)
+			{
+				break;
+			}
+			++Oldest;
+		}
+		RetireTo(Oldest);
+	}
+
+	//readers have to be able to tell a slot's going before it's touched, so Begin moves before any chunk goes back.
+	void RetireTo(uint64 NewBegin)
+	{
+		const uint64 Oldest = Begin.load(std::memory_order_relaxed);
+		if (NewBegin == Oldest)
+		{
+			return;
+		}
+		Begin.store(NewBegin, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_release);
+		for (uint64 Chunk = Oldest / RunsPerChunk; Chunk < NewBegin / RunsPerChunk; ++Chunk)
+		{
+			FreeChunks.Add(Chunks[Chunk % ChunkSlots].load(std::memory_order_relaxed));
+		}
+	}
+
+	//busy worker. only allocates when the live runs reach further than they ever have.
+	FRunChunk* TakeChunk()
+	{
+		if (!FreeChunks.IsEmpty())
+		{
+			return FreeChunks.Pop(EAllowShrinking::No);
+		}
+		return OwnedChunks.Add_GetRef(MakeUnique<FRunChunk>()).Get();
+	}
+
+	const uint64 Capacity;
+	const uint32 ChunkSlots;
+	const TUniquePtr<std::atomic<FRunChunk*>[]> Chunks;
+	const uint64 InputWindow;
+	//busy worker only. every chunk ever made, and the ones no live run is in.
+	TArray<TUniquePtr<FRunChunk>> OwnedChunks;
+	TArray<FRunChunk*> FreeChunks;
+	std::atomic<uint64> Begin = 0;
+	std::atomic<uint64> End = 0;
+};
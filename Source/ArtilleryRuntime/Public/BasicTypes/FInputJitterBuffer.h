@@ -0,0 +1,271 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "BristleconeCommonTypes.h"
+#include "FCablePackedInput.h"
+#include <type_traits>
+
+//What to play for a remote cycle that hasn't shown up in time. takes the last real input and how many cycles in a row
+//we've been guessing, counting this one from 1.
+typedef TFunction<TheCone::PacketElement(TheCone::PacketElement LastReal, uint32 Streak)> FInputPredictor;
+
+namespace ArtilleryInputPrediction
+{
+	//what cabling does locally when it's got nothing. right whenever the player's holding still or holding a direction.
+	inline TheCone::PacketElement RepeatLast(TheCone::PacketElement LastReal, uint32)
+	{
+		return LastReal;
+	}
+
+	//sticks ease back toward center, halving each guess, and events don't repeat. buttons stay held. right more often
+	//than repeat-last once a gap gets long, since people let go of sticks more than they hold them pinned.
+	inline TheCone::PacketElement DecaySticks(TheCone::PacketElement LastReal, uint32 Streak)
+	{
+		static constexpr uint64 StickMask = 0b11111111111;
+		//the field the packer unpacks closest to zero. found once, from the packer, so we don't bake in its bias.
+		static const int64 Center = []()
+		{
+			int64 Best = 0;
+			for (uint64 Field = 1; Field <= StickMask; ++Field)
+			{
+				if (FMath::Abs(FCableInputPacker::UnpackStick(Field)) < FMath::Abs(FCableInputPacker::UnpackStick(Best)))
+				{
+					Best = Field;
+				}
+			}
+			return Best;
+		}();
+		const uint32 Shift = FMath::Min<uint32>(Streak, 11);
+		uint64 Out = LastReal & ~0b111111ull;
+		for (const uint32 At : {53u, 42u, 31u, 20u})
+		{
+			const int64 Field = static_cast<int64>((LastReal >> At) & StickMask);
+			const int64 Decayed = Center + (Field - Center) / (int64(1) << Shift);
+			Out = (Out & ~(StickMask << At)) | (static_cast<uint64>(Decayed) << At);
+		}
+		return Out;
+	}
+}
+
+//Sits between the bristlecone receive queue and a remote control stream. packets carry each input three times (this
+//cycle and the two before), so instead of guessing which copies to replay off a couple of flags, we slot every copy by
+//cycle number, keep the first one we see, and play cycles out in order once their playout tick comes round.
+//
+//playout is cycle + mean transit + jitter * scale, all in busy worker ticks. the sender's cycle is its clock at the same
+//cadence we tick at, so tick - cycle is transit plus a constant, same as ReachedArtilleryAt - SentAt but without having
+//to know what units either of those are in. mean and jitter are the usual 1/16 running estimates. scale is what adapts:
+//every window of played cycles, a miss rate over target widens it and a clean window narrows it, so remote input comes
+//through with the smallest delay that keeps misses under target.
+//
+//a cycle that still hasn't shown up by its playout tick gets a guess from the predictor, and playout keeps going on
+//schedule even when the sender's gone quiet, up to MaxPredictedAhead. the guess is played as a predicted input. when
+//the real one turns up, it's checked against the guess. a right guess is just confirmed. a wrong one is queued as a
+//correction with the stream input it was played as, so the caller can fix the history and roll back from the earliest
+//one. busy worker only.
+class FInputJitterBuffer
+{
+public:
+	typedef TheCone::PacketElement Element;
+	typedef std::decay_t<decltype(std::declval<TheCone::Packet_tpl&>().GetTransferTime())> TransferTime;
+
+	struct FResolution
+	{
+		//the stream input the guess was played as, and the tick it was played on.
+		uint64 StreamInput;
+		uint64 PlayedAt;
+		Element Real;
+		bool Diverged;
+	};
+
+	static constexpr uint64 MaxPredictedAhead = 24;
+
+	static constexpr uint64 Capacity = 64;
+	static constexpr int32 AdaptWindow = 128;
+	static constexpr double TargetMissRate = 0.01;
+	static constexpr double MinScale = 0.5;
+	static constexpr double MaxScale = 8.0;
+
+	explicit FInputJitterBuffer(FInputPredictor InPredictor = &ArtilleryInputPrediction::RepeatLast)
+		: Predictor(MoveTemp(InPredictor))
+	{
+	}
+
+	void Ingest(TheCone::Packet_tpl& Packet, uint64 Tick)
+	{
+		const uint64 Newest = Packet.GetCycleMeta();
+		const TransferTime Sent = Packet.GetTransferTime();
+		//oldest copy first, so a fresh buffer starts from the oldest cycle it knows about.
+		for (uint64 Back = 3; Back-- > 0;)
+		{
+			if (Newest < Back)
+			{
+				continue;
+			}
+			const uint64 Cycle = Newest - Back;
+			if (!bStarted)
+			{
+				NextCycle = Cycle;
+				NewestSeen = Cycle;
+				bStarted = true;
+			}
+			if (Cycle < NextCycle)
+			{
+				Resolve(Cycle, *Packet.GetPointerToElement((Newest + 3 - Back) % 3));
+				continue;
+			}
+			if (Cycle >= NextCycle + Capacity)
+			{
+				//we've fallen so far behind the slots can't hold it. start over from here rather than play stale input.
+				NextCycle = Cycle;
+			}
+			FSlot& Slot = Slots[Cycle % Capacity];
+			if (Slot.Cycle == Cycle)
+			{
+				continue; // a redundant copy.
+			}
+			Slot = {Cycle, *Packet.GetPointerToElement((Newest + 3 - Back) % 3), Sent, 0, 0, false};
+			NewestSeen = FMath::Max(NewestSeen, Cycle);
+			Observe(Cycle, Tick);
+		}
+	}
+
+	//hands every cycle that's due to Sink(Element, TransferTime, bool Predicted), oldest first. Sink returns the stream
+	//input it was added as, which is what corrections point back to. true if anything went out.
+	template <typename SinkType>
+	bool Release(uint64 Tick, SinkType&& Sink)
+	{
+		bool Any = false;
+		//past what we've heard of, we only go as far as the schedule says, and not forever.
+		while (bStarted && NextCycle <= NewestSeen + MaxPredictedAhead)
+		{
+			//if the slots are getting full, we're too far behind to keep waiting on anything.
+			const bool Overrun = NextCycle <= NewestSeen && NewestSeen - NextCycle >= Capacity / 2;
+			if (!Overrun && static_cast<double>(Tick) < static_cast<double>(NextCycle) + GetPlayoutDelay())
+			{
+				break;
+			}
+			FSlot& Slot = Slots[NextCycle % Capacity];
+			const bool Arrived = Slot.Cycle == NextCycle;
+			if (Arrived)
+			{
+				LastReal = Slot.Input;
+				LastSent = Slot.Sent;
+				PredictedStreak = 0;
+				Slot.StreamInput = Sink(Slot.Input, Slot.Sent, false);
+				Slot.PlayedAt = Tick;
+			}
+			else
+			{
+				const Element Guess = Predictor(LastReal, ++PredictedStreak);
+				Slot = {NextCycle, Guess, LastSent, Sink(Guess, LastSent, true), Tick, true};
+			}
+			Adapt(!Arrived);
+			++NextCycle;
+			Any = true;
+		}
+		return Any;
+	}
+
+	//everything that came in for a guessed cycle since the last call, in arrival order. Out's old contents are dropped.
+	//the two arrays trade places, so if the caller keeps Out around, the capacity just goes back and forth.
+	void TakeResolutions(TArray<FResolution>& Out)
+	{
+		Swap(Out, Resolutions);
+		Resolutions.Reset();
+	}
+
+	void SetPredictor(FInputPredictor InPredictor)
+	{
+		Predictor = MoveTemp(InPredictor);
+	}
+
+	//in ticks, past the cycle number. for stats and tuning.
+	double GetPlayoutDelay() const
+	{
+		return MeanOffset + Jitter * Scale;
+	}
+
+	double GetJitter() const
+	{
+		return Jitter;
+	}
+
+private:
+	struct FSlot
+	{
+		uint64 Cycle = MAX_uint64;
+		Element Input = 0;
+		TransferTime Sent = 0;
+		uint64 StreamInput = 0;
+		uint64 PlayedAt = 0;
+		//played as a guess, and the real one hasn't come in yet.
+		bool Predicted = false;
+	};
+
+	//the real input for a cycle we've already played. only guesses care. anything else is a redundant copy.
+	void Resolve(uint64 Cycle, Element Real)
+	{
+		if (NextCycle - Cycle > Capacity)
+		{
+			return; // the slot's been reused. too late to matter.
+		}
+		FSlot& Slot = Slots[Cycle % Capacity];
+		if (Slot.Cycle != Cycle || !Slot.Predicted)
+		{
+			return;
+		}
+		Slot.Predicted = false;
+		Resolutions.Add({Slot.StreamInput, Slot.PlayedAt, Real, Real != Slot.Input});
+		Slot.Input = Real;
+	}
+
+	void Observe(uint64 Cycle, uint64 Tick)
+	{
+		const double Offset = static_cast<double>(Tick) - static_cast<double>(Cycle);
+		if (!bObserved)
+		{
+			MeanOffset = Offset;
+			bObserved = true;
+			return;
+		}
+		const double Deviation = Offset - MeanOffset;
+		MeanOffset += Deviation / 16.0;
+		Jitter += (FMath::Abs(Deviation) - Jitter) / 16.0;
+	}
+
+	void Adapt(bool Missed)
+	{
+		WindowMisses += Missed ? 1 : 0;
+		if (++WindowPlayed < AdaptWindow)
+		{
+			return;
+		}
+		const double MissRate = static_cast<double>(WindowMisses) / WindowPlayed;
+		if (MissRate > TargetMissRate)
+		{
+			Scale = FMath::Min(MaxScale, Scale * 1.25);
+		}
+		else if (WindowMisses == 0)
+		{
+			Scale = FMath::Max(MinScale, Scale * 0.9);
+		}
+		WindowPlayed = 0;
+		WindowMisses = 0;
+	}
+
+	FSlot Slots[Capacity];
+	bool bStarted = false;
+	bool bObserved = false;
+	uint64 NextCycle = 0;
+	uint64 NewestSeen = 0;
+	Element LastReal = 0;
+	TransferTime LastSent = 0;
+	uint32 PredictedStreak = 0;
+	FInputPredictor Predictor;
+	TArray<FResolution> Resolutions;
+	double MeanOffset = 0;
+	double Jitter = 0;
+	double Scale = 2.0;
+	int32 WindowPlayed = 0;
+	int32 WindowMisses = 0;
+};
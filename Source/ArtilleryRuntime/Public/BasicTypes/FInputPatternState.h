@@ -0,0 +1,93 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ArtilleryCommonTypes.h"
+#include "FCablePackedInput.h"
+
+//What a pattern usually wants to know about one input, worked out once when the input arrives instead of every time a
+//pattern sweeps back over the window. flat masks use the GetButtonsAndEventsFlat layout.
+struct FInputPatternFacts
+{
+	uint32 Held = 0;
+	//went down on this input.
+	uint32 Pressed = 0;
+	//came up on this input.
+	uint32 Released = 0;
+	//down for at least ArtilleryHoldSweepBack inputs in a row, ending with this one.
+	uint32 HeldThroughHoldWindow = 0;
+	bool LeftFlick = false;
+	bool RightFlick = false;
+};
+
+//Per-stream incremental matcher state. every input goes through Consume exactly once, on the busy worker, and the state
+//is a fixed size no matter how long the windows are:
+//	press and release edges are a diff against the last input.
+//	holds are a saturating run counter per bit.
+//	flicks are a sliding window minimum over the stick's squared deflection, kept as a monotonic queue, so checking the
+//	window is the front of the queue instead of a rescan.
+class FInputPatternState
+{
+public:
+	static constexpr int32 FlatBits = 20;
+
+	FInputPatternFacts Consume(uint64 Input, uint64 Packed)
+	{
+		FInputPatternFacts Facts;
+		Facts.Held = static_cast<uint32>(Packed & 0b11111111111111111111);
+		Facts.Pressed = Facts.Held & ~LastHeld;
+		Facts.Released = LastHeld & ~Facts.Held;
+		LastHeld = Facts.Held;
+		for (int32 Bit = 0; Bit < FlatBits; ++Bit)
+		{
+			const bool Down = (Facts.Held >> Bit) & 1;
+			HoldRuns[Bit] = Down ? static_cast<uint16>(FMath::Min<uint32>(HoldRuns[Bit] + 1, MAX_uint16)) : 0;
+			Facts.HeldThroughHoldWindow |= (HoldRuns[Bit] >= ArtilleryHoldSweepBack ? 1u : 0u) << Bit;
+		}
+		Facts.LeftFlick = Left.Consume(Input, Packed >> 53, (Packed >> 42) & StickMask);
+		Facts.RightFlick = Right.Consume(Input, (Packed >> 31) & StickMask, (Packed >> 20) & StickMask);
+		return Facts;
+	}
+
+private:
+	static constexpr uint64 StickMask = 0b11111111111;
+
+	struct FFlickTracker
+	{
+		//true on the input where the stick crosses out past the flick boundary, having come far enough from its lowest
+		//point inside the sweep back.
+		bool Consume(uint64 Input, uint64 FieldX, uint64 FieldY)
+		{
+			const int64 X = static_cast<int32>(FCableInputPacker::DebiasStick(FieldX));
+			const int64 Y = static_cast<int32>(FCableInputPacker::DebiasStick(FieldY));
+			const uint64 Magnitude = static_cast<uint64>(X * X + Y * Y);
+			//drop anything that's aged out of the window, then anything this input makes irrelevant as a minimum.
+			while (Count > 0 && Input - Window[Head].Key >= ArtilleryFlickSweepBack)
+			{
+				Head = (Head + 1) % Capacity;
+				--Count;
+			}
+			while (Count > 0 && Window[(Head + Count - 1) % Capacity].Value >= Magnitude)
+			{
+				--Count;
+			}
+			Window[(Head + Count) % Capacity] = {Input, Magnitude};
+			++Count;
+			const bool Outside = Magnitude >= ArtilleryMagicFlickBoundary;
+			const bool Flicked = Outside && !WasOutside && Magnitude - Window[Head].Value >= ArtilleryMagicMinimumFlickDistanceRequired;
+			WasOutside = Outside;
+			return Flicked;
+		}
+
+		//one more than the window, so the new entry always fits before the old front ages out.
+		static constexpr int32 Capacity = ArtilleryFlickSweepBack + 1;
+		TPair<uint64, uint64> Window[Capacity];
+		int32 Head = 0;
+		int32 Count = 0;
+		bool WasOutside = false;
+	};
+
+	uint32 LastHeld = 0;
+	uint16 HoldRuns[FlatBits] = {};
+	FFlickTracker Left;
+	FFlickTracker Right;
+};
@@ -14,4 +14,8 @@ struct FProjectileDefinitionRow : public FTableRowBase
 
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category=ProjectileDefinition)
 	FString ProjectileMeshLocation;
+
+	//health taken off whatever this hits, folded in with any proposed damage on the same tick.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category=ProjectileDefinition)
+	double ImpactDamage = 100;
 };
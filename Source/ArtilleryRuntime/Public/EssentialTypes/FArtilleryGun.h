@@ -41,10 +41,19 @@ public:
 	FGunKey MyGunKey;
 	ActorKey MyProbableOwner;
 	bool ReadyToFire = false;
+	//if set, the busy worker resolves this gun's shots at sim rate through SimFireGun, and the game thread only ever
+	//sees PlayFireCues. the GAS chain starting at PreFireGun is not run for these guns.
+	bool ResolvesOnSimThread = false;
+	//if set before prewarm, this gun uses its definition's shared ability set instead of rooting seven of its own.
+	//the key reaches a shared ability through its activation's event data, never by being written onto it. anything
+	//latent has to copy the event data rather than hold the pointer, same as any other gameplay ability.
+	bool SharesAbilities = false;
 
 	UArtilleryDispatch* MyDispatch;
 	UArtilleryProjectileDispatch* MyProjectileDispatch;
 	TSharedPtr<FAttributeMap> MyAttributes;
+	//the starting values for this gun's attributes, shared by its definition. every equip stamps these back over MyAttributes.
+	TSharedPtr<const TMap<AttribKey, double>> AttributeTemplate;
 
 	// Owner Components
 	TWeakObjectPtr<UCameraComponent> PlayerCameraComponent;
@@ -103,7 +112,8 @@ public:
 
 	virtual ~FArtilleryGun()
 	{
-		if(Prefire != nullptr) //we always assign all or none, so we can just check prefire atm. this might change.
+		//shared abilities belong to the dispatch, which unroots them at teardown.
+		if(Prefire != nullptr && !SharesAbilities) //we always assign all or none, so we can just check prefire atm. this might change.
 		{
 			Prefire->RemoveFromRoot();
 			Fire->RemoveFromRoot();
@@ -115,10 +125,64 @@ public:
 		}
 	}
 
+	//shared abilities hold no gun of their own, so every activation carries ours as target data in its event.
+	//the ability itself is never written to. see UArtilleryPerActorAbilityMinimum::GetActivatingGun.
+	//the event and its target data are built once, at prewarm, and every phase of every shot reuses them. nothing in
+	//the tree fires with event data of its own. a caller that does pays for one copy of it per phase.
+	void ActivatePhase(
+		UArtilleryPerActorAbilityMinimum* Phase,
+		const FGameplayAbilitySpecHandle Handle,
+		const FGameplayAbilityActorInfo* ActorInfo,
+		const FGameplayAbilityActivationInfo ActivationInfo,
+		const FGameplayEventData* TriggerEventData) const
+	{
+		checkf(GunTarget.IsValid(), TEXT("FArtilleryGun: Prewarm or Initialize before firing."));
+		//subclasses are allowed to set their own key late, so this follows it rather than trusting prewarm's.
+		GunTarget->Gun = MyGunKey;
+		if (TriggerEventData == nullptr)
+		{
+			Phase->CallActivateAbility(Handle, ActorInfo, ActivationInfo, nullptr, &KeyedEvent);
+			return;
+		}
+		FGameplayEventData Keyed = *TriggerEventData;
+		Keyed.TargetData.Data.Add(GunTarget);
+		Phase->CallActivateAbility(Handle, ActorInfo, ActivationInfo, nullptr, &Keyed);
+	}
+
+	//made once at prewarm and reused for every shot. the fire control machine hands this back in as the handle.
+	FGameplayAbilitySpecHandle FireHandle;
+
+	//the phase binders are bound once, to the dispatch, and never by a gun. when prefire or fire ends, the dispatch
+	//looks the gun up by the key the activation carried and hands the end back here, with what this shot started with.
+	void OnPhaseEnded(
+		bool PrefireEnded,
+		FArtilleryStates OutcomeStates,
+		int DallyFramesToOmit,
+		const FGameplayAbilityActorInfo* ActorInfo,
+		const FGameplayAbilityActivationInfo ActivationInfo)
+	{
+		if (PrefireEnded)
+		{
+			FireGun(OutcomeStates, DallyFramesToOmit, ActorInfo, ActivationInfo, ShotRerun, ShotEventData, ShotHandle);
+		}
+		else
+		{
+			PostFireGun(OutcomeStates, DallyFramesToOmit, ActorInfo, ActivationInfo, ShotRerun, ShotEventData, ShotHandle);
+		}
+	}
+
 	void UpdateProbableOwner(ActorKey ProbableOwner)
 	{
 		MyProbableOwner = ProbableOwner;
 	}
+
+	//whoever hands out the gun says which world it's in, before prewarm or initialize. there's no guessing from GWorld,
+	//which is whatever world happened to tick last, and with more than one match that's not ours.
+	void BindDispatch(UArtilleryDispatch* OwningDispatch)
+	{
+		MyDispatch = OwningDispatch;
+		MyProjectileDispatch = OwningDispatch->GetWorld()->GetSubsystem<UArtilleryProjectileDispatch>();
+	}
 	//I'm sick and tired of the endless layers of abstraction.
 	//Here's how it works. we fire the abilities from the gun.
 	//OnGameplayAbilityEnded doesn't actually let you know if the ability was canceled.
@@ -131,15 +195,13 @@ public:
 		bool RerunDueToReconcile = false,
 		int DallyFramesToOmit = 0)
 	{
-		// Delegate type:
-		// DECLARE_DELEGATE_FiveParams FArtilleryAbilityStateAlert
-		Prefire->GunBinder.BindRaw(this, &FArtilleryGun::FireGun, RerunDueToReconcile, TriggerEventData, Handle);
-		Fire->GunBinder.BindRaw(this, &FArtilleryGun::PostFireGun, RerunDueToReconcile, TriggerEventData, Handle);
-		Prefire->CallActivateAbility(FGameplayAbilitySpecHandle(), ActorInfo, ActivationInfo, nullptr,
-		                             TriggerEventData);
+		ShotRerun = RerunDueToReconcile;
+		ShotEventData = TriggerEventData;
+		ShotHandle = Handle;
+		ActivatePhase(Prefire, FGameplayAbilitySpecHandle(), ActorInfo, ActivationInfo, TriggerEventData);
 		if (!RerunDueToReconcile)
 		{
-			PrefireCosmetic->CallActivateAbility(Handle, ActorInfo, ActivationInfo, nullptr, TriggerEventData);
+			ActivatePhase(PrefireCosmetic, Handle, ActorInfo, ActivationInfo, TriggerEventData);
 		}
 	};
 
@@ -172,14 +234,12 @@ public:
 		}
 		if (OutcomeStates == FArtilleryStates::Fired)
 		{
-			Fire->CallActivateAbility(FGameplayAbilitySpecHandle(), ActorInfo, ActivationInfo, nullptr,
-			                          TriggerEventData);
+			ActivatePhase(Fire, FGameplayAbilitySpecHandle(), ActorInfo, ActivationInfo, TriggerEventData);
 			//TODO: BUILD CORRECT HANDLE HANDLING. HANDLES ARE OUR TICKET OUT OF THIS JOINT.
 			if (!RerunDueToReconcile)
 			{
 				//TODO: BUILD CORRECT HANDLE HANDLING. HANDLES ARE OUR TICKET OUT OF THIS JOINT.
-				FireCosmetic->CallActivateAbility(FGameplayAbilitySpecHandle(), ActorInfo, ActivationInfo, nullptr,
-				                                  TriggerEventData);
+				ActivatePhase(FireCosmetic, FGameplayAbilitySpecHandle(), ActorInfo, ActivationInfo, TriggerEventData);
 			}
 		}
 		else
@@ -187,8 +247,7 @@ public:
 			if (!RerunDueToReconcile)
 			{
 				//TODO: BUILD CORRECT HANDLE HANDLING. HANDLES ARE OUR TICKET OUT OF THIS JOINT.
-				FailedFireCosmetic->CallActivateAbility(FGameplayAbilitySpecHandle(), ActorInfo, ActivationInfo,
-				                                        nullptr, TriggerEventData);
+				ActivatePhase(FailedFireCosmetic, FGameplayAbilitySpecHandle(), ActorInfo, ActivationInfo, TriggerEventData);
 			}
 		}
 	};
@@ -204,14 +263,12 @@ public:
 	{
 		if (OutcomeStates == FArtilleryStates::Fired)
 		{
-			PostFire->CallActivateAbility(FGameplayAbilitySpecHandle(), ActorInfo, ActivationInfo, nullptr,
-			                              TriggerEventData);
+			ActivatePhase(PostFire, FGameplayAbilitySpecHandle(), ActorInfo, ActivationInfo, TriggerEventData);
 			//TODO: BUILD CORRECT HANDLE HANDLING. HANDLES ARE OUR TICKET OUT OF THIS JOINT.
 			if (!RerunDueToReconcile)
 			{
 				//TODO: BUILD CORRECT HANDLE HANDLING. HANDLES ARE OUR TICKET OUT OF THIS JOINT.
-				PostFireCosmetic->CallActivateAbility(FGameplayAbilitySpecHandle(), ActorInfo, ActivationInfo, nullptr,
-				                                      TriggerEventData);
+				ActivatePhase(PostFireCosmetic, FGameplayAbilitySpecHandle(), ActorInfo, ActivationInfo, TriggerEventData);
 			}
 		}
 		else
@@ -219,12 +276,75 @@ public:
 			if (!RerunDueToReconcile)
 			{
 				//TODO: BUILD CORRECT HANDLE HANDLING. HANDLES ARE OUR TICKET OUT OF THIS JOINT.
-				FailedFireCosmetic->CallActivateAbility(FGameplayAbilitySpecHandle(), ActorInfo, ActivationInfo,
-				                                        nullptr, TriggerEventData);
+				ActivatePhase(FailedFireCosmetic, FGameplayAbilitySpecHandle(), ActorInfo, ActivationInfo, TriggerEventData);
 			}
 		}
 	};
 
+	//the standard ammo and cooldown gate. safe from the busy worker, it's all conserved attributes.
+	bool CanFireNow() const
+	{
+		AttrPtr CooldownRemainingPtr = MyDispatch->GetAttrib(MyGunKey, COOLDOWN_REMAINING);
+		AttrPtr AmmoRemainingPtr = MyDispatch->GetAttrib(MyGunKey, AMMO);
+		return CooldownRemainingPtr.IsValid() && CooldownRemainingPtr->GetCurrentValue() <= 0.f
+			&& AmmoRemainingPtr.IsValid() && AmmoRemainingPtr->GetCurrentValue() > 0.f;
+	}
+
+	//spends the round and starts the cooldown. also safe from the busy worker. Now is sim time, GetShadowNow.
+	void CommitShot(ArtilleryTime Now) const
+	{
+		AttrPtr AmmoPtr = MyDispatch->GetAttrib(MyGunKey, AMMO);
+		if (AmmoPtr.IsValid())
+		{
+			AmmoPtr->SetCurrentValue(AmmoPtr->GetCurrentValue() - 1);
+		}
+		AttrPtr CooldownPtr = MyDispatch->GetAttrib(MyGunKey, COOLDOWN);
+		AttrPtr CooldownRemainingPtr = MyDispatch->GetAttrib(MyGunKey, COOLDOWN_REMAINING);
+		if (CooldownPtr.IsValid() && CooldownRemainingPtr.IsValid())
+		{
+			CooldownRemainingPtr->SetCurrentValue(CooldownPtr->GetCurrentValue());
+		}
+		AttrPtr TicksSincePtr = MyDispatch->GetAttrib(MyGunKey, TICKS_SINCE_GUN_LAST_FIRED);
+		if (TicksSincePtr.IsValid())
+		{
+			TicksSincePtr->SetCurrentValue(0.f);
+		}
+		AttrPtr LastFiredPtr = MyDispatch->GetAttrib(MyGunKey, AttribKey::LastFiredTimestamp);
+		if (LastFiredPtr.IsValid())
+		{
+			LastFiredPtr->SetCurrentValue(static_cast<double>(Now));
+		}
+	}
+
+	//BUSY WORKER ONLY. Mechanical resolution for guns with ResolvesOnSimThread set. returns true if the shot went off.
+	//no uobjects, no actors, no gas in here. override it to add hitscan or whatever else your gun does at sim rate.
+	virtual bool SimFireGun(ArtilleryTime Now)
+	{
+		if (!CanFireNow())
+		{
+			return false;
+		}
+		CommitShot(Now);
+		return true;
+	}
+
+	//Game thread. Plays the cosmetic abilities for a shot SimFireGun already resolved.
+	virtual void PlayFireCues(
+		bool Fired,
+		const FGameplayAbilityActorInfo* ActorInfo,
+		const FGameplayAbilityActivationInfo ActivationInfo)
+	{
+		if (Fired)
+		{
+			ActivatePhase(FireCosmetic, FGameplayAbilitySpecHandle(), ActorInfo, ActivationInfo, nullptr);
+			ActivatePhase(PostFireCosmetic, FGameplayAbilitySpecHandle(), ActorInfo, ActivationInfo, nullptr);
+		}
+		else
+		{
+			ActivatePhase(FailedFireCosmetic, FGameplayAbilitySpecHandle(), ActorInfo, ActivationInfo, nullptr);
+		}
+	}
+
 	//The unusual presence of the modal switch AND a requirement for the related parameter is due to the
 	//various fun vagaries of inheritance. IF you override this function, and any valid child class should,
 	//then you'll want to have some assurance of fine-grained control there over all your parent classes.
@@ -246,21 +366,10 @@ public:
 	{
 		MyGunKey = KeyFromDispatch;
 		//assign gunkey
-		
-		MyDispatch = GWorld->GetSubsystem<UArtilleryDispatch>();
-		MyProjectileDispatch = GWorld->GetSubsystem<UArtilleryProjectileDispatch>();
-
-		TMap<AttribKey, double> InitialGunAttributes = TMap<AttribKey, double>();
-		// TODO: load more stats and dynamically rather than fixed demo values
-		InitialGunAttributes.Add(AMMO, MaxAmmo);
-		InitialGunAttributes.Add(MAX_AMMO, MaxAmmo);
-		InitialGunAttributes.Add(COOLDOWN, Firerate);
-		InitialGunAttributes.Add(COOLDOWN_REMAINING, 0);
-		InitialGunAttributes.Add(RELOAD, ReloadTime);
-		InitialGunAttributes.Add(RELOAD_REMAINING, 0);
-		InitialGunAttributes.Add(TICKS_SINCE_GUN_LAST_FIRED, 0);
-		InitialGunAttributes.Add(AttribKey::LastFiredTimestamp, 0);
-		MyAttributes = MakeShareable(new FAttributeMap(MyGunKey, MyDispatch, InitialGunAttributes));
+
+		//a prewarmed gun has already done all of this. a fresh one does it now.
+		Prewarm(PF, PFC, F, FC, PtF, PtFc, FFC);
+		MyAttributes->Rebind(MyGunKey, *AttributeTemplate);
 		MyDispatch->REGISTER_GUN_FINAL_TICK_RESOLVER(MyGunKey);
 
 		UTransformDispatch* TransformDispatch = MyDispatch->GetWorld()->GetSubsystem<UTransformDispatch>();
@@ -270,6 +379,61 @@ PlayerCameraComponent
 		 = ActorPointer->GetComponentByClass<UCameraComponent>();
 		FiringPointComponent = Cast<USceneComponent, UObject>(ActorPointer->GetDefaultSubobjectByName(TEXT("WeaponFiringPoint")));
 		
+		//shared abilities get the key per activation. writing it onto them would hand it to every gun of the definition.
+		if(!MyCodeWillSetGunKey && !SharesAbilities)
+		{
+			SetGunKey(MyGunKey);
+		}
+		ReadyToFire = ReadyToFire || !MyCodeWillSetGunKey;
+		return ReadyToFire;
+	}
+
+	//Everything a gun allocates that doesn't depend on who holds it: the attribute block and the abilities.
+	//The dispatch calls this at level load for pooled guns, and Initialize calls it for anything that wasn't pooled.
+	//idempotent. the second call is free.
+	void Prewarm(
+		UArtilleryPerActorAbilityMinimum* PF = nullptr,
+		UArtilleryPerActorAbilityMinimum* PFC = nullptr,
+		UArtilleryPerActorAbilityMinimum* F = nullptr,
+		UArtilleryPerActorAbilityMinimum* FC = nullptr,
+		UArtilleryPerActorAbilityMinimum* PtF = nullptr,
+		UArtilleryPerActorAbilityMinimum* PtFc = nullptr,
+		UArtilleryPerActorAbilityMinimum* FFC = nullptr)
+	{
+		checkf(MyDispatch != nullptr, TEXT("FArtilleryGun: BindDispatch before Prewarm or Initialize."));
+
+		if (!AttributeTemplate.IsValid())
+		{
+			AttributeTemplate = MyDispatch->GetAttributeTemplate(MyGunKey.GunDefinitionIndex, MaxAmmo, Firerate, ReloadTime);
+		}
+		if (!MyAttributes.IsValid())
+		{
+			MyAttributes = MakeShareable(new FAttributeMap());
+			MyAttributes->Prepare(MyDispatch, *AttributeTemplate);
+		}
+		if (!FireHandle.IsValid())
+		{
+			FireHandle = FGameplayAbilitySpecHandle::GenerateNewHandle();
+		}
+		if (!GunTarget.IsValid())
+		{
+			GunTarget = MakeShared<FArtilleryGunTargetData>(MyGunKey);
+			KeyedEvent.TargetData.Data.Add(GunTarget);
+		}
+
+		if(Prefire == nullptr && SharesAbilities && !(PF || PFC || F || FC || PtF || PtFc || FFC))
+		{
+			const FArtilleryAbilitySet& Shared = MyDispatch->GetSharedAbilities(MyGunKey.GunDefinitionIndex);
+			Prefire = Shared.Prefire;
+			PrefireCosmetic = Shared.PrefireCosmetic;
+			Fire = Shared.Fire;
+			FireCosmetic = Shared.FireCosmetic;
+			PostFire = Shared.PostFire;
+			PostFireCosmetic = Shared.PostFireCosmetic;
+			FailedFireCosmetic = Shared.FailedFireCosmetic;
+		}
+		SharesAbilities = SharesAbilities && Prefire != nullptr;
+
 		//we'd like to do it earlier, but there's actually not a great moment to do this.
 		if(Prefire == nullptr)
 		{
@@ -288,13 +452,8 @@ PlayerCameraComponent
 			PostFireCosmetic->AddToRoot();
 			FailedFireCosmetic = FFC ? FFC : NewObject<UArtilleryPerActorAbilityMinimum>();
 			FailedFireCosmetic->AddToRoot();
+			MyDispatch->BindGunPhases(Prefire, Fire);
 		}
-		if(!MyCodeWillSetGunKey)
-		{
-			SetGunKey(MyGunKey);
-		}
-		ReadyToFire = ReadyToFire || !MyCodeWillSetGunKey;
-		return ReadyToFire;
 	}
 
 	void SetGunKey(FGunKey NewKey) const
@@ -314,6 +473,15 @@ PlayerCameraComponent
 
 
 private:
+	//the event every phase is activated with. see ActivatePhase.
+	TSharedPtr<FArtilleryGunTargetData> GunTarget;
+	FGameplayEventData KeyedEvent;
+
+	//what the shot in flight started with. PreFireGun sets these and OnPhaseEnded passes them on.
+	bool ShotRerun = false;
+	const FGameplayEventData* ShotEventData = nullptr;
+	FGameplayAbilitySpecHandle ShotHandle;
+
 	//Our debug value remains M6D.
 	static const inline FGunKey Default = FGunKey("M6D", UINT64_MAX);
 };
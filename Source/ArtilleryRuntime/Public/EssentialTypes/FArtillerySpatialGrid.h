@@ -0,0 +1,236 @@
+#pragma once
+#include "CoreMinimal.h"
+#include "SkeletonTypes.h"
+#include "Algo/BinarySearch.h"
+
+//A uniform hash grid over whatever keys are registered for proximity queries. rebuilt from scratch every tick by the
+//ticklites worker, before calculate, and only read after that, so every ticklite in a tick sees the same frozen picture
+//and nobody needs a lock. rebuild is a counting sort, two passes over the entries and no per-entry allocation.
+//
+//cells hash into a fixed bucket table, so two far-apart cells can share a bucket. every query checks real distance,
+//so that only ever costs a few extra compares.
+class FArtillerySpatialGrid
+{
+public:
+	explicit FArtillerySpatialGrid(double InCellSize = 1000.0) : CellSize(InCellSize), InverseCellSize(1.0 / InCellSize)
+	{
+	}
+
+	//Keys and Locations are paired by index.
+	void Rebuild(TConstArrayView<FSkeletonKey> Keys, TConstArrayView<FVector3d> Locations)
+	{
+		check(Keys.Num() == Locations.Num());
+		const int32 Count = Keys.Num();
+		BucketMask = FMath::RoundUpToPowerOfTwo(FMath::Max(Count * 2, 64)) - 1;
+		BucketStarts.Reset();
+		BucketStarts.SetNumZeroed(BucketMask + 2);
+		EntryBuckets.SetNumUninitialized(Count, EAllowShrinking::No);
+		for (int32 i = 0; i < Count; ++i)
+		{
+			EntryBuckets[i] = BucketOf(CellOf(Locations[i]));
+			++BucketStarts[EntryBuckets[i] + 1];
+		}
+		for (uint32 b = 1; b < static_cast<uint32>(BucketStarts.Num()); ++b)
+		{
+			BucketStarts[b] += BucketStarts[b - 1];
+		}
+		Entries.SetNumUninitialized(Count, EAllowShrinking::No);
+		Cursor = BucketStarts;
+		for (int32 i = 0; i < Count; ++i)
+		{
+			Entries[Cursor[EntryBuckets[i]]++] = {Keys[i], Locations[i]};
+		}
+	}
+
+	int32 Num() const
+	{
+		return Entries.Num();
+	}
+
+	//everything within Radius of Center. appends.
+	void QueryRadius(const FVector3d& Center, double Radius, TArray<FSkeletonKey>& Out) const
+	{
+		const double RadiusSquared = Radius * Radius;
+		ForEachInBox(Center - FVector3d(Radius), Center + FVector3d(Radius), [&](const FEntry& Entry)
+		{
+			if (FVector3d::DistSquared(Entry.Location, Center) <= RadiusSquared)
+			{
+				Out.Add(Entry.Key);
+			}
+		});
+	}
+
+	//everything within Range of Origin and within HalfAngleRadians of Direction. Direction should be normalized. appends.
+	void QueryCone(const FVector3d& Origin, const FVector3d& Direction, double HalfAngleRadians, double Range, TArray<FSkeletonKey>& Out) const
+	{
+		const double RangeSquared = Range * Range;
+		const double CosHalfAngle = FMath::Cos(HalfAngleRadians);
+		ForEachInBox(Origin - FVector3d(Range), Origin + FVector3d(Range), [&](const FEntry& Entry)
+		{
+			const FVector3d ToEntry = Entry.Location - Origin;
+			const double DistanceSquared = ToEntry.SizeSquared();
+			if (DistanceSquared > RangeSquared)
+			{
+				return;
+			}
+			//the origin itself counts as inside.
+			if (DistanceSquared <= UE_DOUBLE_SMALL_NUMBER || FVector3d::DotProduct(ToEntry, Direction) >= CosHalfAngle * FMath::Sqrt(DistanceSquared))
+			{
+				Out.Add(Entry.Key);
+			}
+		});
+	}
+
+	//up to K nearest to Center within MaxRadius, closest first. replaces Out. grows the search a ring of cells at a time,
+	//and stops once the kth best is closer than anything the next ring could hold.
+	void QueryNearest(const FVector3d& Center, int32 K, double MaxRadius, TArray<FSkeletonKey>& Out) const
+	{
+		Out.Reset();
+		if (K <= 0 || Entries.IsEmpty())
+		{
+			return;
+		}
+		TArray<TPair<double, FSkeletonKey>, TInlineAllocator<16>> Best;
+		const double MaxRadiusSquared = MaxRadius * MaxRadius;
+		const FIntVector Home = CellOf(Center);
+		const int32 MaxRing = FMath::CeilToInt32(MaxRadius * InverseCellSize) + 1;
+		TSet<uint32, DefaultKeyFuncs<uint32>, TInlineSetAllocator<64>> Visited;
+		auto Consider = [&](uint32 Bucket)
+		{
+			for (int32 i = BucketStarts[Bucket]; i < BucketStarts[Bucket + 1]; ++i)
+			{
+				const double DistanceSquared = FVector3d::DistSquared(Entries[i].Location, Center);
+				if (DistanceSquared > MaxRadiusSquared || (Best.Num() >= K && DistanceSquared >= Best.Last().Key))
+				{
+					continue;
+				}
+				const int32 At = Algo::UpperBoundBy(Best, DistanceSquared, [](const TPair<double, FSkeletonKey>& Pair) { return Pair.Key; });
+				Best.Insert({DistanceSquared, Entries[i].Key}, At);
+				if (Best.Num() > K)
+				{
+					Best.Pop(EAllowShrinking::No);
+				}
+			}
+		};
+		for (int32 Ring = 0; Ring <= MaxRing; ++Ring)
+		{
+			//anything in this ring is at least (Ring - 1) cells away.
+			const double RingFloor = FMath::Max(0, Ring - 1) * CellSize;
+			if (Best.Num() >= K && RingFloor * RingFloor > Best.Last().Key)
+			{
+				break;
+			}
+			//once a ring's bigger than the table, finishing off the buckets we haven't seen is cheaper than walking it.
+			const int64 Side = 2 * Ring + 1;
+			if (Side * Side * Side > static_cast<int64>(BucketMask) + 1)
+			{
+				for (uint32 Bucket = 0; Bucket <= BucketMask; ++Bucket)
+				{
+					if (!Visited.Contains(Bucket))
+					{
+						Consider(Bucket);
+					}
+				}
+				break;
+			}
+			for (int32 X = -Ring; X <= Ring; ++X)
+			{
+				for (int32 Y = -Ring; Y <= Ring; ++Y)
+				{
+					for (int32 Z = -Ring; Z <= Ring; ++Z)
+					{
+						if (FMath::Max3(FMath::Abs(X), FMath::Abs(Y), FMath::Abs(Z)) != Ring)
+						{
+							continue; // interior, already done.
+						}
+						const uint32 Bucket = BucketOf(Home + FIntVector(X, Y, Z));
+						bool AlreadyVisited = false;
+						Visited.Add(Bucket, &AlreadyVisited);
+						if (!AlreadyVisited)
+						{
+							Consider(Bucket);
+						}
+					}
+				}
+			}
+		}
+		Out.Reserve(Best.Num());
+		for (const TPair<double, FSkeletonKey>& Found : Best)
+		{
+			Out.Add(Found.Value);
+		}
+	}
+
+private:
+	struct FEntry
+	{
+		FSkeletonKey Key;
+		FVector3d Location;
+	};
+
+	FIntVector CellOf(const FVector3d& Location) const
+	{
+		return FIntVector(
+			FMath::FloorToInt32(Location.X * InverseCellSize),
+			FMath::FloorToInt32(Location.Y * InverseCellSize),
+			FMath::FloorToInt32(Location.Z * InverseCellSize));
+	}
+
+	uint32 BucketOf(const FIntVector& Cell) const
+	{
+		//the usual three big primes.
+		const uint32 Hash = static_cast<uint32>(Cell.X) * 73856093u ^ static_cast<uint32>(Cell.Y) * 19349663u ^ static_cast<uint32>(Cell.Z) * 83492791u;
+		return Hash & BucketMask;
+	}
+
+	//visits each bucket touched by the box once. a box bigger than the table just walks the table.
+	template <typename Visitor>
+	void ForEachInBox(const FVector3d& Min, const FVector3d& Max, Visitor&& Visit) const
+	{
+		if (Entries.IsEmpty())
+		{
+			return;
+		}
+		const FIntVector Low = CellOf(Min);
+		const FIntVector High = CellOf(Max);
+		const int64 CellCount = static_cast<int64>(High.X - Low.X + 1) * (High.Y - Low.Y + 1) * (High.Z - Low.Z + 1);
+		if (CellCount > static_cast<int64>(BucketMask) + 1)
+		{
+			for (const FEntry& Entry : Entries)
+			{
+				Visit(Entry);
+			}
+			return;
+		}
+		TSet<uint32, DefaultKeyFuncs<uint32>, TInlineSetAllocator<64>> Visited;
+		for (int32 X = Low.X; X <= High.X; ++X)
+		{
+			for (int32 Y = Low.Y; Y <= High.Y; ++Y)
+			{
+				for (int32 Z = Low.Z; Z <= High.Z; ++Z)
+				{
+					const uint32 Bucket = BucketOf(FIntVector(X, Y, Z));
+					bool AlreadyVisited = false;
+					Visited.Add(Bucket, &AlreadyVisited);
+					if (AlreadyVisited)
+					{
+						continue;
+					}
+					for (int32 i = BucketStarts[Bucket]; i < BucketStarts[Bucket + 1]; ++i)
+					{
+						Visit(Entries[i]);
+					}
+				}
+			}
+		}
+	}
+
+	double CellSize;
+	double InverseCellSize;
+	uint32 BucketMask = 0;
+	//all of these are kept between rebuilds, so a steady entity count means no allocation.
+	TArray<int32> BucketStarts;
+	TArray<int32> Cursor;
+	TArray<uint32> EntryBuckets;
+	TArray<FEntry> Entries;
+};
@@ -52,9 +52,52 @@ struct ARTILLERYRUNTIME_API FAttributeMap
 		ReadyToUse = true;
 	};
 	
+	//Builds the attribute block without registering it anywhere. Used for pooled guns, which don't have a key yet.
+	void Prepare(UArtilleryDispatch* MyDispatchIn, const TMap<AttribKey, double>& Template)
+	{
+		this->MyDispatch = MyDispatchIn;
+		this->MyAttributes = MakeShareable(new AttributeMap());
+		MyAttributes->Reserve(Template.Num());
+		for(auto x : Template)
+		{
+			MyAttributes->Add(x.Key, MakeShareable(new FConservedAttributeData));
+		}
+		ReadyToUse = false;
+	};
+
+	//Moves an existing block to a new owner and stamps the template values back over it. Nothing is allocated unless the
+	//template names an attribute this block doesn't have yet.
+	void Rebind(FSkeletonKey NewParentKey, const TMap<AttribKey, double>& Template)
+	{
+		if (ReadyToUse)
+		{
+			MyDispatch->DeregisterAttributes(ParentKey);
+		}
+		this->ParentKey = NewParentKey;
+		//the busy worker can still be reading this block under the old key until it catches up, so a block that has to
+		//grow is copied rather than added to.
+		for(auto x : Template)
+		{
+			if (!MyAttributes->Contains(x.Key))
+			{
+				MyAttributes = MakeShareable(new AttributeMap(*MyAttributes));
+				break;
+			}
+		}
+		for(auto x : Template)
+		{
+			AttrPtr* Existing = MyAttributes->Find(x.Key);
+			AttrPtr Attribute = Existing ? *Existing : MyAttributes->Add(x.Key, MakeShareable(new FConservedAttributeData));
+			Attribute->SetBaseValue(x.Value);
+			Attribute->SetCurrentValue(x.Value);
+		}
+		MyDispatch->RegisterAttributes(ParentKey, MyAttributes);
+		ReadyToUse = true;
+	};
+	
 	~FAttributeMap()
 	{
-		if (MyAttributes != nullptr)
+		if (MyAttributes != nullptr && ReadyToUse)
 		{
 			MyDispatch->DeregisterAttributes(ParentKey);
 		}
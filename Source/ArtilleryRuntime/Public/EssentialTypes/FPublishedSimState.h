@@ -0,0 +1,315 @@
+#pragma once
+#include "CoreMinimal.h"
+#include "SkeletonTypes.h"
+#include "EAttributes.h"
+#include "Containers/Queue.h"
+#include "Containers/TripleBuffer.h"
+
+//What the game thread and blueprints read instead of the live attributes. once per tick, after apply, the ticklites
+//worker copies every registered entity's attributes and identities into a flat table and publishes it. the game thread
+//latches the newest table at the top of its tick and reads only that until the next latch. a hud reading health and max
+//health in the same frame gets both from the same sim tick, and nothing on the game thread touches an attribute the sim
+//is halfway through writing.
+//
+//the tables sit in a triple buffer, so publishing and latching are each one swap and neither side waits on the other.
+//
+//watched attributes also get a change list. the publisher keeps a bit per (row, attribute) for whether anyone's
+//watching and the last value it sent, and only the watched ones that moved go out, one batch per tick. the game thread
+//drains batches up to the tick it latched, so its work follows what changed, not what's being watched.
+class FPublishedSimState
+{
+public:
+	//keep these in step with EAttributes.h.
+	static constexpr int32 AttribCount = static_cast<int32>(E_AttribKey::LastFiredTimestamp) + 1;
+	static constexpr int32 IdentCount = static_cast<int32>(E_IdentityAttrib::EquippedDashAbility) + 1;
+	static_assert(AttribCount <= 32, "watch masks are a uint32 per row");
+
+	struct FAttributeChange
+	{
+		FSkeletonKey Key;
+		E_AttribKey Attrib;
+		float Value;
+	};
+
+	//Any thread. picked up by the next publish.
+	void Track(FSkeletonKey Key, Arty::AttrMapPtr Attributes)
+	{
+		Changes.Enqueue({Key, Attributes, nullptr, EMembershipOp::Attributes});
+	}
+	void Track(FSkeletonKey Key, Arty::IdMapPtr Identities)
+	{
+		Changes.Enqueue({Key, nullptr, Identities, EMembershipOp::Identities});
+	}
+	void UntrackAttributes(FSkeletonKey Key)
+	{
+		Changes.Enqueue({Key, nullptr, nullptr, EMembershipOp::Attributes});
+	}
+	void UntrackIdentities(FSkeletonKey Key)
+	{
+		Changes.Enqueue({Key, nullptr, nullptr, EMembershipOp::Identities});
+	}
+	//Game thread. the first change after a watch starts is the current value, so watchers don't have to go read it.
+	void Watch(FSkeletonKey Key, E_AttribKey Attrib)
+	{
+		Changes.Enqueue({Key, nullptr, nullptr, EMembershipOp::Watch, Attrib});
+	}
+	void Unwatch(FSkeletonKey Key, E_AttribKey Attrib)
+	{
+		Changes.Enqueue({Key, nullptr, nullptr, EMembershipOp::Unwatch, Attrib});
+	}
+
+	//Ticklites worker, once apply's done.
+	void Publish()
+	{
+		ApplyChanges();
+		FTable& Table = Tables.GetWriteBuffer();
+		//the key index only gets copied when someone came or went, and then once per table.
+		if (Table.Membership != Membership)
+		{
+			Table.RowByKey = RowByKey;
+			Table.Membership = Membership;
+		}
+		Table.Tick = ++Published;
+		const int32 RowCount = Rows.Num();
+		Table.Attributes.SetNumUninitialized(RowCount * AttribCount, EAllowShrinking::No);
+		Table.Identities.SetNumUninitialized(RowCount * IdentCount, EAllowShrinking::No);
+		Table.HasIdentity.Init(false, RowCount * IdentCount);
+		TArray<FAttributeChange> Changed;
+		for (int32 Row = 0; Row < RowCount; ++Row)
+		{
+			float* Attributes = &Table.Attributes[Row * AttribCount];
+			for (int32 i = 0; i < AttribCount; ++i)
+			{
+				Attributes[i] = NAN; // same thing the blueprint nodes hand back for a miss.
+			}
+			if (Rows[Row].Attributes.IsValid())
+			{
+				for (const TPair<Arty::AttribKey, Arty::AttrPtr>& Attribute : *Rows[Row].Attributes)
+				{
+					if (Attribute.Value.IsValid())
+					{
+						Attributes[static_cast<int32>(Attribute.Key)] = Attribute.Value->GetCurrentValue();
+					}
+				}
+			}
+			if (Rows[Row].Identities.IsValid())
+			{
+				for (const TPair<Arty::Ident, Arty::IdentPtr>& Identity : *Rows[Row].Identities)
+				{
+					if (Identity.Value.IsValid())
+					{
+						const int32 At = Row * IdentCount + static_cast<int32>(Identity.Key);
+						Table.Identities[At] = Identity.Value->CurrentValue;
+						Table.HasIdentity[At] = true;
+					}
+				}
+			}
+			for (uint32 Watched = Rows[Row].WatchMask; Watched != 0; Watched &= Watched - 1)
+			{
+				const int32 i = FMath::CountTrailingZeros(Watched);
+				float& Last = Rows[Row].LastSent[i];
+				//nan to nan is no change. a missing attribute shouldn't report every tick.
+				if (Attributes[i] != Last && !(FMath::IsNaN(Attributes[i]) && FMath::IsNaN(Last)))
+				{
+					Last = Attributes[i];
+					Changed.Add({Rows[Row].Key, static_cast<E_AttribKey>(i), Attributes[i]});
+				}
+			}
+		}
+		Tables.SwapWriteBuffers();
+		if (!Changed.IsEmpty())
+		{
+			ChangeBatches.Enqueue({Published, MoveTemp(Changed)});
+		}
+	}
+
+	//Game thread, after Latch. hands every watched change up to the latched tick to Visit, oldest first. a value that
+	//moved more than once shows up more than once.
+	template <typename Visitor>
+	void DrainChanges(Visitor&& Visit)
+	{
+		const uint64 Latched = GetTick();
+		while (const TPair<uint64, TArray<FAttributeChange>>* Batch = ChangeBatches.Peek())
+		{
+			if (Batch->Key > Latched)
+			{
+				return; // not in the table we're reading yet.
+			}
+			for (const FAttributeChange& Change : Batch->Value)
+			{
+				Visit(Change);
+			}
+			ChangeBatches.Pop();
+		}
+	}
+
+	//Game thread, once per frame. false if there was nothing new.
+	bool Latch()
+	{
+		if (!Tables.IsDirty())
+		{
+			return false;
+		}
+		Tables.SwapReadBuffers();
+		return true;
+	}
+
+	//Game thread. everything below reads the latched table.
+	bool GetAttribute(FSkeletonKey Key, E_AttribKey Attrib, float& Out) const
+	{
+		const FTable& Table = Tables.Read();
+		const int32* Row = Table.RowByKey.Find(Key);
+		if (!Row)
+		{
+			return false;
+		}
+		Out = Table.Attributes[*Row * AttribCount + static_cast<int32>(Attrib)];
+		return !FMath::IsNaN(Out);
+	}
+
+	bool GetIdentity(FSkeletonKey Key, E_IdentityAttrib Attrib, FSkeletonKey& Out) const
+	{
+		const FTable& Table = Tables.Read();
+		const int32* Row = Table.RowByKey.Find(Key);
+		if (!Row)
+		{
+			return false;
+		}
+		const int32 At = *Row * IdentCount + static_cast<int32>(Attrib);
+		if (!Table.HasIdentity[At])
+		{
+			return false;
+		}
+		Out = Table.Identities[At];
+		return true;
+	}
+
+	//which publish the latched table came from. 0 until the first one lands.
+	uint64 GetTick() const
+	{
+		return Tables.Read().Tick;
+	}
+
+private:
+	struct FTable
+	{
+		uint64 Tick = 0;
+		uint32 Membership = 0;
+		TMap<FSkeletonKey, int32> RowByKey;
+		//row major, AttribCount per row. NAN where the entity doesn't have that attribute.
+		TArray<float> Attributes;
+		//row major, IdentCount per row.
+		TArray<FSkeletonKey> Identities;
+		TBitArray<> HasIdentity;
+	};
+
+	struct FRow
+	{
+		FSkeletonKey Key;
+		Arty::AttrMapPtr Attributes;
+		Arty::IdMapPtr Identities;
+		uint32 WatchMask = 0;
+		float LastSent[AttribCount];
+	};
+
+	enum class EMembershipOp : uint8
+	{
+		Attributes,
+		Identities,
+		Watch,
+		Unwatch
+	};
+
+	struct FChange
+	{
+		FSkeletonKey Key;
+		Arty::AttrMapPtr Attributes;
+		Arty::IdMapPtr Identities;
+		EMembershipOp Op;
+		E_AttribKey Attrib = E_AttribKey::Speed;
+	};
+
+	//watches outlive rows, so something watched before it registers, or across a respawn, still reports.
+	void ApplyWatch(const FChange& Change)
+	{
+		const uint32 Bit = 1u << static_cast<uint32>(Change.Attrib);
+		uint32& Mask = WatchMasks.FindOrAdd(Change.Key);
+		Mask = Change.Op == EMembershipOp::Watch ? Mask | Bit : Mask & ~Bit;
+		const uint32 NewMask = Mask;
+		if (NewMask == 0)
+		{
+			WatchMasks.Remove(Change.Key);
+		}
+		if (const int32* Row = RowByKey.Find(Change.Key))
+		{
+			Rows[*Row].WatchMask = NewMask;
+			Rows[*Row].LastSent[static_cast<int32>(Change.Attrib)] = NAN;
+		}
+	}
+
+	//a row lives as long as it has either attributes or identities. rows are kept dense with swap removes.
+	void ApplyChanges()
+	{
+		FChange Change;
+		while (Changes.Dequeue(Change))
+		{
+			if (Change.Op == EMembershipOp::Watch || Change.Op == EMembershipOp::Unwatch)
+			{
+				ApplyWatch(Change);
+				continue;
+			}
+			const bool bRemoving = !Change.Attributes.IsValid() && !Change.Identities.IsValid();
+			int32 Row = INDEX_NONE;
+			if (const int32* Found = RowByKey.Find(Change.Key))
+			{
+				Row = *Found;
+			}
+			else if (bRemoving)
+			{
+				continue;
+			}
+			else
+			{
+				Row = Rows.AddDefaulted();
+				Rows[Row].Key = Change.Key;
+				Rows[Row].WatchMask = WatchMasks.FindRef(Change.Key);
+				for (float& Last : Rows[Row].LastSent)
+				{
+					Last = NAN;
+				}
+				RowByKey.Add(Change.Key, Row);
+				++Membership;
+			}
+			if (Change.Op == EMembershipOp::Attributes)
+			{
+				Rows[Row].Attributes = Change.Attributes;
+			}
+			else
+			{
+				Rows[Row].Identities = Change.Identities;
+			}
+			if (!Rows[Row].Attributes.IsValid() && !Rows[Row].Identities.IsValid())
+			{
+				RowByKey.Remove(Change.Key);
+				if (Row != Rows.Num() - 1)
+				{
+					Rows[Row] = MoveTemp(Rows.Last());
+					RowByKey[Rows[Row].Key] = Row;
+				}
+				Rows.Pop(EAllowShrinking::No);
+				++Membership;
+			}
+		}
+	}
+
+	TTripleBuffer<FTable> Tables;
+	TQueue<FChange, EQueueMode::Mpsc> Changes;
+	//single producer (ticklites worker), single consumer (game thread). tagged with the publish they came from.
+	TQueue<TPair<uint64, TArray<FAttributeChange>>, EQueueMode::Spsc> ChangeBatches;
+	//ticklites worker only.
+	TArray<FRow> Rows;
+	TMap<FSkeletonKey, int32> RowByKey;
+	TMap<FSkeletonKey, uint32> WatchMasks;
+	uint32 Membership = 0;
+	uint64 Published = 0;
+};
@@ -0,0 +1,177 @@
+#pragma once
+#include "CoreMinimal.h"
+#include "SkeletonTypes.h"
+#include "Containers/CircularQueue.h"
+#include <atomic>
+
+//Latest two sim transforms per key, written by the busy worker and read by the game thread without locks.
+//the sim runs at 120 and the game thread runs at whatever it runs at, so instead of replaying every queued update each
+//frame, the game thread reads the newest pair for the keys it can actually see and lerps between them. one tick of delay,
+//no judder.
+//
+//slots are handed out on the game thread, because that's where things get spawned and cleaned up, and the sim learns about
+//them through an spsc queue. each slot is a seqlock: the writer bumps the sequence to odd, writes, bumps to even. readers
+//retry if they saw odd or if it moved under them. the slot also carries its key, so a reader holding a slot that's been
+//handed to someone else just gets a miss.
+class FTransformSnapshotBuffer
+{
+public:
+	explicit FTransformSnapshotBuffer(int32 InCapacity)
+		: Capacity(InCapacity), Slots(new FSlot[InCapacity]), SlotChanges(InCapacity)
+	{
+		FreeSlots.Reserve(Capacity);
+		for (int32 i = Capacity - 1; i >= 0; --i)
+		{
+			FreeSlots.Add(i);
+		}
+	}
+
+	//Game thread. INDEX_NONE when full, in which case the key's updates keep coming through the transform pump.
+	int32 Allocate(FSkeletonKey Key)
+	{
+		if (FreeSlots.IsEmpty())
+		{
+			return INDEX_NONE;
+		}
+		const int32 Slot = FreeSlots.Pop(false);
+		if (!SlotChanges.Enqueue({Key, Slot}))
+		{
+			FreeSlots.Push(Slot);
+			return INDEX_NONE;
+		}
+		return Slot;
+	}
+
+	//Game thread. the sim sees the release before it sees whoever gets the slot next, so it never writes the old key into it.
+	void Release(FSkeletonKey Key, int32 Slot)
+	{
+		if (Slot == INDEX_NONE)
+		{
+			return;
+		}
+		//if the sim can't hear about the release, the slot can't be reused safely. leak it rather than cross the streams.
+		if (SlotChanges.Enqueue({Key, INDEX_NONE}))
+		{
+			FreeSlots.Push(Slot);
+		}
+	}
+
+	//Busy worker. picks up whatever the game thread allocated or released since last tick.
+	void SyncSlots()
+	{
+		TPair<FSkeletonKey, int32> Change;
+		while (SlotChanges.Dequeue(Change))
+		{
+			if (Change.Value == INDEX_NONE)
+			{
+				SlotByKey.Remove(Change.Key);
+				continue;
+			}
+			SlotByKey.Add(Change.Key, Change.Value);
+			FSlot& Slot = Slots[Change.Value];
+			Slot.Sequence.fetch_add(1, std::memory_order_acq_rel);
+			Slot.Key = Change.Key;
+			Slot.Fresh = true;
+			Slot.Sequence.fetch_add(1, std::memory_order_release);
+		}
+	}
+
+	//Busy worker. false if the key doesn't have a slot, so the caller can send it the old way.
+	bool Write(FSkeletonKey Key, const FVector3f& Position, const FQuat4f& Rotation)
+	{
+		const int32* Found = SlotByKey.Find(Key);
+		if (!Found)
+		{
+			return false;
+		}
+		FSlot& Slot = Slots[*Found];
+		Slot.Sequence.fetch_add(1, std::memory_order_acq_rel);
+		//the first sample is both samples. nothing to lerp from yet.
+		Slot.PreviousPosition = Slot.Fresh ? Position : Slot.Position;
+		Slot.PreviousRotation = Slot.Fresh ? Rotation : Slot.Rotation;
+		Slot.Position = Position;
+		Slot.Rotation = Rotation;
+		Slot.Fresh = false;
+		Slot.Sequence.fetch_add(1, std::memory_order_release);
+		return true;
+	}
+
+	//Busy worker, once the tick's writes are done.
+	void PublishTick(double Seconds)
+	{
+		PreviousPublish.store(LastPublish.load(std::memory_order_relaxed), std::memory_order_relaxed);
+		LastPublish.store(Seconds, std::memory_order_release);
+	}
+
+	//Game thread. how far we are between the last two published ticks, clamped.
+	float GetAlpha(double Now) const
+	{
+		const double Last = LastPublish.load(std::memory_order_acquire);
+		const double Interval = Last - PreviousPublish.load(std::memory_order_relaxed);
+		if (Interval <= 0)
+		{
+			return 1.f;
+		}
+		return static_cast<float>(FMath::Clamp((Now - Last) / Interval, 0.0, 1.0));
+	}
+
+	//Game thread. false if the slot doesn't belong to this key anymore or hasn't been written yet.
+	bool Sample(int32 SlotIndex, FSkeletonKey Key, float Alpha, FVector& OutPosition, FQuat& OutRotation) const
+	{
+		if (SlotIndex < 0 || SlotIndex >= Capacity)
+		{
+			return false;
+		}
+		const FSlot& Slot = Slots[SlotIndex];
+		for (int32 Attempt = 0; Attempt < 4; ++Attempt)
+		{
+			const uint32 Before = Slot.Sequence.load(std::memory_order_acquire);
+			if (Before & 1)
+			{
+				continue;
+			}
+			const FSkeletonKey SlotKey = Slot.Key;
+			const bool Fresh = Slot.Fresh;
+			const FVector3f PreviousPosition = Slot.PreviousPosition;
+			const FVector3f Position = Slot.Position;
+			const FQuat4f PreviousRotation = Slot.PreviousRotation;
+			const FQuat4f Rotation = Slot.Rotation;
+			std::atomic_thread_fence(std::memory_order_acquire);
+			if (Slot.Sequence.load(std::memory_order_relaxed) != Before)
+			{
+				continue;
+			}
+			if (SlotKey != Key || Fresh)
+			{
+				return false;
+			}
+			OutPosition = FVector(FMath::Lerp(PreviousPosition, Position, Alpha));
+			OutRotation = FQuat(FQuat4f::Slerp(PreviousRotation, Rotation, Alpha));
+			return true;
+		}
+		return false; // the writer kept us out. we'll catch it next frame.
+	}
+
+private:
+	struct FSlot
+	{
+		std::atomic<uint32> Sequence = 0;
+		FSkeletonKey Key;
+		bool Fresh = true;
+		FVector3f PreviousPosition = FVector3f::ZeroVector;
+		FVector3f Position = FVector3f::ZeroVector;
+		FQuat4f PreviousRotation = FQuat4f::Identity;
+		FQuat4f Rotation = FQuat4f::Identity;
+	};
+
+	int32 Capacity;
+	TUniquePtr<FSlot[]> Slots;
+	//game thread only.
+	TArray<int32> FreeSlots;
+	//busy worker only.
+	TMap<FSkeletonKey, int32> SlotByKey;
+	//single producer (game thread), single consumer (busy worker).
+	TCircularQueue<TPair<FSkeletonKey, int32>> SlotChanges;
+	std::atomic<double> LastPublish = 0;
+	std::atomic<double> PreviousPublish = 0;
+};
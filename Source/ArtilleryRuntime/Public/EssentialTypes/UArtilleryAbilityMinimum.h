@@ -11,6 +11,7 @@
 #include "GameplayAbilitySpecHandle.h"
 
 #include "Abilities/GameplayAbilityTypes.h"
+#include "Abilities/GameplayAbilityTargetTypes.h"
 #include "GameplayEffect.h"
 #include "FGunKey.h"
 
@@ -79,7 +80,32 @@ enum FArtilleryStates
 
 
 
-DECLARE_DELEGATE_FourParams(FArtilleryAbilityStateAlert, FArtilleryStates, int, const FGameplayAbilityActorInfo*, const FGameplayAbilityActivationInfo);
+//the gun comes first so one binding can serve every gun that shares the ability. see UArtilleryDispatch::OnGunPhaseEnded.
+DECLARE_DELEGATE_FiveParams(FArtilleryAbilityStateAlert, FGunKey, FArtilleryStates, int, const FGameplayAbilityActorInfo*, const FGameplayAbilityActivationInfo);
+
+//Which gun an activation is for. FArtilleryGun adds one of these to the event data of every phase it activates, so an
+//ability shared by every gun of a definition can tell them apart without anyone writing to it.
+USTRUCT()
+struct ARTILLERYRUNTIME_API FArtilleryGunTargetData : public FGameplayAbilityTargetData
+{
+	GENERATED_BODY()
+
+	FArtilleryGunTargetData()
+	{
+	}
+
+	explicit FArtilleryGunTargetData(const FGunKey& InGun) : Gun(InGun)
+	{
+	}
+
+	UPROPERTY()
+	FGunKey Gun;
+
+	virtual UScriptStruct* GetScriptStruct() const override
+	{
+		return StaticStruct();
+	}
+};
 
 
 UCLASS(BlueprintType)
@@ -108,8 +134,12 @@ public:
 	int AvailableDallyFrames = 0;
 
 	
+	//only set for abilities a single gun owns. shared abilities leave this alone, see GetActivatingGun.
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Gun")
 	FGunKey MyGunKey;
+
+	//the gun carried in the activation's event data if there is one, and MyGunKey if not.
+	FGunKey GetActivatingGun(const FGameplayEventData* TriggerEventData) const;
 	/*
 	// Add the Ability's tags to the given GameplayEffectSpec. This is likely to be overridden per project.
 	virtual void ApplyAbilityTagsToGameplayEffectSpec(FGameplayEffectSpec& Spec, FGameplayAbilitySpec* AbilitySpec) const;
@@ -190,7 +220,10 @@ public:
 	virtual void CancelAbility(const FGameplayAbilitySpecHandle Handle, const FGameplayAbilityActorInfo* ActorInfo, const FGameplayAbilityActivationInfo ActivationInfo, bool bReplicateCancelAbility) override;
 
 private:
-
+	//the gun this activation is for, taken from the event data in PreActivate so EndAbility can name it. this is the
+	//same kind of per-activation bookkeeping as CurrentActorInfo, not ability state. a shared phase that goes latent
+	//has to end before its definition fires it again, same as any other instanced-per-actor ability.
+	FGunKey ActivatingGun;
 
 	//these have no function in the Artillery ability sequence.
 	void InputPressed(const FGameplayAbilitySpecHandle Handle, const FGameplayAbilityActorInfo* ActorInfo, const FGameplayAbilityActivationInfo ActivationInfo) override {};
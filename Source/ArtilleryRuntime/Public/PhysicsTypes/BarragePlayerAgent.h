@@ -82,6 +82,8 @@ private:
 	// Currently targeted object
 	FBLet TargetFiblet;
 	TWeakObjectPtr<AActor> TargetPtr;
+	//reused every call. aim friction runs every frame, no reason to allocate a hit each time.
+	TSharedPtr<FHitResult> AimHit;
 };
 
 //CONSTRUCTORS
@@ -203,7 +205,12 @@ inline void UBarragePlayerAgent::ApplyAimFriction(
 	FBLet MyFiblet = Physics->GetShapeRef(ActorsKey);
 	check(MyFiblet); // The actor calling this sure as hell better be allocated already
 
-	TSharedPtr<FHitResult> HitObjectResult = MakeShared<FHitResult>();
+	if (!AimHit.IsValid())
+	{
+		AimHit = MakeShared<FHitResult>();
+	}
+	*AimHit = FHitResult();
+	TSharedPtr<FHitResult> HitObjectResult = AimHit;
 	Physics->SphereCast(
 		MyFiblet->KeyIntoBarrage,
 		0.01f,
@@ -245,6 +252,6 @@ inline void UBarragePlayerAgent::ApplyAimFriction(
 		TotalFriction = 0.5f;
 	}
 
-	UE_LOG(LogTemp, Warning, TEXT("Target found, applying friction to reticle ('%f')"), TotalFriction);
+	UE_LOG(LogTemp, VeryVerbose, TEXT("Target found, applying friction to reticle ('%f')"), TotalFriction);
 	OutAimVector *= TotalFriction;
 }
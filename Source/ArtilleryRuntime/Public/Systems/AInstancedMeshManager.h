@@ -22,8 +22,14 @@ class ARTILLERYRUNTIME_API AInstancedMeshManager : public AActor
 	UArtilleryDispatch* MyDispatch;
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category=Artillery, meta = (AllowPrivateAccess = "true"))
 	UTransformDispatch* TransformDispatch;
+	//not a uproperty, world subsystems outlive us. cached so spawning doesn't go back through the world every time.
+	UBarrageDispatch* Physics;
 
 	uint32 instances_generated;
+	//busy worker only. see CreateSimBody.
+	uint32 SimKeysMinted = 0;
+	//the full box extents of the mesh, computed once when the mesh is set. bounding box is radius not diameter.
+	FVector3d InstanceExtents;
 
 	virtual void BeginPlay() override
 	{
@@ -31,23 +37,38 @@ class ARTILLERYRUNTIME_API AInstancedMeshManager : public AActor
 
 		if(!IsDefaultSubobject())
 		{
-			MyDispatch = GetWorld()->GetSubsystem<UArtilleryDispatch>();
-			TransformDispatch = GetWorld()->GetSubsystem<UTransformDispatch>();
 			// No Chaos for you!
 			SwarmKineManager->SetEnableGravity(false);
 			SwarmKineManager->SetSimulatePhysics(false);
 			SwarmKineManager->DestroyPhysicsState();
-
-			// Make a key yo
-			auto keyHash = PointerHash(this);
-			UE_LOG(LogTemp, Warning, TEXT("AInstancedMeshManager Parented: %d"), keyHash);
-			MyKey = ActorKey(keyHash);
-			Usable = true;
+			Prime();
 		}
 	}
 
 public:
 	bool Usable = false;
+
+	//keys us and caches the subsystems. safe to call more than once. the projectile dispatch calls it between a deferred
+	//spawn and FinishSpawning, because a manager spawned during world begin play doesn't get BeginPlay until the level's
+	//actors do, and it gets registered under its key long before that.
+	void Prime()
+	{
+		if(Usable || IsDefaultSubobject())
+		{
+			return;
+		}
+		MyDispatch = GetWorld()->GetSubsystem<UArtilleryDispatch>();
+		TransformDispatch = GetWorld()->GetSubsystem<UTransformDispatch>();
+		Physics = GetWorld()->GetSubsystem<UBarrageDispatch>();
+
+		// Make a key yo
+		auto keyHash = PointerHash(this);
+		UE_LOG(LogTemp, Warning, TEXT("AInstancedMeshManager Parented: %d"), keyHash);
+		MyKey = ActorKey(keyHash);
+		Snapshots = MyDispatch->GetTransformSnapshots();
+		MyDispatch->RegisterSnapshotReader(this);
+		Usable = true;
+	}
 	
 	AInstancedMeshManager()
 	{
@@ -55,6 +76,9 @@ public:
 		SwarmKineManager->bDisableCollision = true;
 		MyDispatch = nullptr;
 		TransformDispatch = nullptr;
+		Physics = nullptr;
+		instances_generated = 0;
+		InstanceExtents = FVector3d::ZeroVector;
 	}
 	
 	ActorKey GetMyKey() const
@@ -65,6 +89,10 @@ public:
 	void SetStaticMesh(UStaticMesh* Mesh)
 	{
 		SwarmKineManager->SetStaticMesh(Mesh);
+		if(Mesh)
+		{
+			InstanceExtents = Mesh->GetBoundingBox().GetExtent() * 2;
+		}
 	}
 
 	UFUNCTION(BlueprintCallable, Category = Instance)
@@ -74,47 +102,287 @@ public:
 	}
 	FSkeletonKey CreateNewInstance(const FTransform& WorldTransform, const FVector3d& MuzzleVelocity, const uint16_t Layer, bool IsSensor = false)
 	{
+		FParkedInstance Recycled;
+		if (TakeParked(WorldTransform, Recycled))
+		{
+			return BindNewInstance(Recycled.Id, Recycled.Key, WorldTransform, MuzzleVelocity, Layer, IsSensor);
+		}
 		FPrimitiveInstanceId NewInstanceId = SwarmKineManager->AddInstanceById(WorldTransform, true);
-		// TODO: Does this make a good hash? Can we hash collide?
-		// TODO: Oh god this definitely birthday problems at some point but I don't know how else to get a unique hash since the instances rotate around and reuse the same memory
-		auto hash = PointerHash(SwarmKineManager, ++instances_generated);
-		UE_LOG(LogTemp, Warning, TEXT("NewInstanceId: %i"), hash);
-		FSkeletonKey NewInstanceKey = FSkeletonKey(hash);
+		return BindNewInstance(NewInstanceId, MintKey(NewInstanceId), WorldTransform, MuzzleVelocity, Layer, IsSensor);
+	}
 
-		SwarmKineManager->AddToMap(NewInstanceId, NewInstanceKey);
+	//Bulk version of the above for shotguns, swarms, and anything else that fires more than one thing a tick.
+	//the ISM instances are added in one call, the bounds are the cached ones, and the subsystems are only looked up once.
+	//Transforms and velocities are paired by index, so they must be the same length. Keys come out in the same order.
+	void CreateNewInstances(TArrayView<const FTransform> WorldTransforms, TArrayView<const FVector3d> MuzzleVelocities,
+		const uint16_t Layer, bool IsSensor, TArray<FSkeletonKey>& OutKeys)
+	{
+		check(WorldTransforms.Num() == MuzzleVelocities.Num());
+		if(WorldTransforms.IsEmpty())
+		{
+			return;
+		}
+		OutKeys.Reserve(OutKeys.Num() + WorldTransforms.Num());
+		//parked instances first, then whatever's left goes to the ism in one call.
+		int32 Recycled = 0;
+		FParkedInstance Parked;
+		while(Recycled < WorldTransforms.Num() && TakeParked(WorldTransforms[Recycled], Parked))
+		{
+			OutKeys.Add(BindNewInstance(Parked.Id, Parked.Key, WorldTransforms[Recycled], MuzzleVelocities[Recycled], Layer, IsSensor));
+			++Recycled;
+		}
+		if(Recycled == WorldTransforms.Num())
+		{
+			return;
+		}
+		TArray<FPrimitiveInstanceId> NewInstanceIds = SwarmKineManager->AddInstancesById(WorldTransforms.RightChop(Recycled), true);
+		for(int32 i = 0; i < NewInstanceIds.Num(); ++i)
+		{
+			OutKeys.Add(BindNewInstance(NewInstanceIds[i], MintKey(NewInstanceIds[i]), WorldTransforms[Recycled + i], MuzzleVelocities[Recycled + i], Layer, IsSensor));
+		}
+	}
 
-		// TODO: can't use the BarrageColliderBase set of types, so in-lining the barrage setup code. Is this what we want long-term?
-		auto Physics = GetWorld()->GetSubsystem<UBarrageDispatch>();
-		auto TransformECS =  GetWorld()->GetSubsystem<UTransformDispatch>();
-		auto AnyMesh = SwarmKineManager->GetStaticMesh();
-		auto Boxen = AnyMesh->GetBoundingBox();
-		auto extents = Boxen.GetExtent() * 2;
+	//Busy worker. the sim's half of a spawn, a key and a body, so the shot is in the sim the tick it's fired. nothing here
+	//touches what the game thread owns. the extents are set before the projectile dispatch hands us to the sim, and
+	//never change after. the mesh comes later, in AdoptSimInstance.
+	FSkeletonKey CreateSimBody(const FTransform& WorldTransform, const FVector3d& MuzzleVelocity, const uint16_t Layer, bool IsSensor)
+	{
+		const FSkeletonKey NewKey = FSkeletonKey(PointerHash(this, ++SimKeysMinted));
+		MakeBody(NewKey, WorldTransform, MuzzleVelocity, Layer, IsSensor);
+		return NewKey;
+	}
 
-		auto params = FBarrageBounder::GenerateBoxBounds(WorldTransform.GetLocation(), extents.X, extents.Y, extents.Z,
-			FVector3d(0, 0, extents.Z/2));
+	//Game thread. the other half of CreateSimBody. always a fresh ism instance, since a parked one is mapped to its old key.
+	void AdoptSimInstance(const FSkeletonKey Key, const FTransform& WorldTransform)
+	{
+		const FPrimitiveInstanceId NewInstanceId = SwarmKineManager->AddInstanceById(WorldTransform, true);
+		SwarmKineManager->AddToMap(NewInstanceId, Key);
+		InstanceByKey.Add(Key, {NewInstanceId, WorldTransform.GetScale3D(),
+			Snapshots.IsValid() ? Snapshots->Allocate(Key) : INDEX_NONE});
+		TransformDispatch->RegisterObjectToShadowTransform(Key, SwarmKineManager);
+	}
 
-		FBLet MyBarrageBody = Physics->CreatePrimitive(params, NewInstanceKey, Layer, IsSensor);
-		FBarragePrimitive::SetVelocity(MuzzleVelocity, MyBarrageBody);
+	//Game thread. collects a sim transform for one of our instances; nothing touches the ism until the flush.
+	//returns true on the first update since the last flush, so the caller knows to flush us.
+	bool QueueInstanceTransform(const FSkeletonKey Target, const FVector& Position, const FQuat& Rotation)
+	{
+		const FInstanceSlot* Slot = InstanceByKey.Find(Target);
+		if (!Slot)
+		{
+			return false;
+		}
+		PendingTransforms.Add({Slot->Id, FTransform(Rotation, Position, Slot->Scale)});
+		return PendingTransforms.Num() == 1;
+	}
 
-		TransformDispatch->RegisterObjectToShadowTransform(NewInstanceKey, SwarmKineManager);
+	//Game thread, once a frame. pulls the interpolated transform for every instance with a snapshot slot. when nobody's
+	//seen us lately the interpolation is skipped and instances just take the newest sim transform. they still have to
+	//move, since the ism's bounds come from them, and stale bounds would keep a projectile flying into view culled.
+	//returns true if anything was queued.
+	bool InterpolateInstances(const FTransformSnapshotBuffer& From, float Alpha)
+	{
+		if (!WasRecentlyRendered(0.2f))
+		{
+			Alpha = 1.f;
+		}
+		FVector Position;
+		FQuat Rotation;
+		const int32 Before = PendingTransforms.Num();
+		for (const TPair<FSkeletonKey, FInstanceSlot>& Instance : InstanceByKey)
+		{
+			if (From.Sample(Instance.Value.Snapshot, Instance.Key, Alpha, Position, Rotation))
+			{
+				PendingTransforms.Add({Instance.Value.Id, FTransform(Rotation, Position, Instance.Value.Scale)});
+			}
+		}
+		return PendingTransforms.Num() > Before;
+	}
 
-		MyDispatch->REGISTER_PROJECTILE_FINAL_TICK_RESOLVER(100, NewInstanceKey);
-		
-		return NewInstanceKey;
+	//pushes everything queued this tick in as few batch calls as the instance indices allow, which is one when every
+	//projectile moved, and dirties render state once. per instance, this is a sort entry and a copy.
+	void FlushInstanceTransforms()
+	{
+		if (PendingTransforms.IsEmpty())
+		{
+			return;
+		}
+		for (FPendingTransform& Pending : PendingTransforms)
+		{
+			Pending.Index = SwarmKineManager->GetInstanceIndexForId(Pending.Id);
+		}
+		//stable, so when two sim ticks land in one frame the later transform wins below.
+		PendingTransforms.StableSort([](const FPendingTransform& A, const FPendingTransform& B)
+		{
+			return A.Index < B.Index;
+		});
+
+		int32 RunStart = INDEX_NONE;
+		for (const FPendingTransform& Pending : PendingTransforms)
+		{
+			if (Pending.Index == INDEX_NONE)
+			{
+				continue; // removed since it was queued.
+			}
+			if (RunStart != INDEX_NONE && Pending.Index == RunStart + BatchScratch.Num() - 1)
+			{
+				BatchScratch.Last() = Pending.Transform;
+				continue;
+			}
+			if (RunStart != INDEX_NONE && Pending.Index == RunStart + BatchScratch.Num())
+			{
+				BatchScratch.Add(Pending.Transform);
+				continue;
+			}
+			if (RunStart != INDEX_NONE)
+			{
+				SwarmKineManager->BatchUpdateInstancesTransforms(RunStart, BatchScratch, true, false, true);
+			}
+			RunStart = Pending.Index;
+			BatchScratch.Reset();
+			BatchScratch.Add(Pending.Transform);
+		}
+		if (RunStart != INDEX_NONE)
+		{
+			SwarmKineManager->BatchUpdateInstancesTransforms(RunStart, BatchScratch, true, false, true);
+			SwarmKineManager->MarkRenderStateDirty();
+		}
+		PendingTransforms.Reset();
+		BatchScratch.Reset();
 	}
 
 	// THIS MUST BE CALLED OR ELSE THE MAPPINGS WILL KEEP THE LIVE REFERENCE 4EVA
 
+	//the ism instance and its key aren't thrown away. the instance is collapsed to zero scale where it is and set aside,
+	//key and swarmkine mapping and all, and the next spawn takes it back instead of adding an instance and minting a key.
+	//the barrage body isn't kept. barrage has no way to move or rekey a body it already made, so it goes to the tombstone
+	//and the next spawn makes a new one.
 	void CleanupInstance(const FSkeletonKey Target)
 	{
 		// TODO: Not sure how if this cleans up the FBLet in Jolt
 		// Tombstones don't seem to do anything? UBarrageDispatch::Entomb is never called
-		auto Physics = GetWorld()->GetSubsystem<UBarrageDispatch>();
 		Physics->SuggestTombstone(Physics->GetShapeRef(Target));
-		SwarmKineManager->CleanupInstance(Target);
 		TransformDispatch->ReleaseKineByKey(Target);
+		FInstanceSlot Released;
+		if (!InstanceByKey.RemoveAndCopyValue(Target, Released))
+		{
+			return;
+		}
+		if (Snapshots.IsValid())
+		{
+			Snapshots->Release(Target, Released.Snapshot);
+		}
+		const int32 Index = SwarmKineManager->GetInstanceIndexForId(Released.Id);
+		if (Parked.Num() - ParkedHead >= MaxParkedInstances || Index == INDEX_NONE)
+		{
+			SwarmKineManager->CleanupInstance(Target);
+			return;
+		}
+		//anything still queued from this frame would put it back at full size on the flush.
+		PendingTransforms.RemoveAll([&Released](const FPendingTransform& Pending)
+		{
+			return Pending.Id == Released.Id;
+		});
+		FTransform Hidden;
+		SwarmKineManager->GetInstanceTransform(Index, Hidden, true);
+		Hidden.SetScale3D(FVector::ZeroVector);
+		SwarmKineManager->UpdateInstanceTransform(Index, Hidden, true, true, true);
+		Parked.Add({Released.Id, Target, MyDispatch->GetShadowNow()});
 	}
 
 private:
 	ActorKey MyKey;
+
+	struct FInstanceSlot
+	{
+		FPrimitiveInstanceId Id;
+		//sim updates carry position and rotation only.
+		FVector Scale;
+		//INDEX_NONE if the snapshots were full, in which case our updates come through the pump instead.
+		int32 Snapshot;
+	};
+	struct FPendingTransform
+	{
+		FPrimitiveInstanceId Id;
+		FTransform Transform;
+		int32 Index = INDEX_NONE;
+	};
+	TMap<FSkeletonKey, FInstanceSlot> InstanceByKey;
+
+	//a parked key can't come back until everything keyed to its old life is gone: the tombstoned body and any contacts
+	//already in flight. two seconds is well past both. shadow time is in microseconds.
+	static constexpr ArtilleryTime RecycleQuarantine = 2 * 1000000;
+	static constexpr int32 MaxParkedInstances = 1024;
+	struct FParkedInstance
+	{
+		FPrimitiveInstanceId Id;
+		FSkeletonKey Key;
+		ArtilleryTime ParkedAt = 0;
+	};
+	//oldest first, so only the front ever needs checking against the quarantine.
+	TArray<FParkedInstance> Parked;
+	int32 ParkedHead = 0;
+	//reused every tick. see FlushInstanceTransforms.
+	TArray<FPendingTransform> PendingTransforms;
+	TArray<FTransform> BatchScratch;
+	TSharedPtr<FTransformSnapshotBuffer> Snapshots;
+
+	//pops the oldest parked instance if it's out of quarantine, and puts it back at full size where it's being spawned.
+	bool TakeParked(const FTransform& WorldTransform, FParkedInstance& Out)
+	{
+		if (ParkedHead == Parked.Num() || MyDispatch->GetShadowNow() - Parked[ParkedHead].ParkedAt < RecycleQuarantine)
+		{
+			return false;
+		}
+		Out = Parked[ParkedHead++];
+		if (ParkedHead * 2 >= Parked.Num())
+		{
+			Parked.RemoveAt(0, ParkedHead, EAllowShrinking::No);
+			ParkedHead = 0;
+		}
+		const int32 Index = SwarmKineManager->GetInstanceIndexForId(Out.Id);
+		if (Index == INDEX_NONE)
+		{
+			return false;
+		}
+		SwarmKineManager->UpdateInstanceTransform(Index, WorldTransform, true, true, true);
+		return true;
+	}
+
+	FSkeletonKey MintKey(FPrimitiveInstanceId NewInstanceId)
+	{
+		// TODO: Does this make a good hash? Can we hash collide?
+		// TODO: Oh god this definitely birthday problems at some point but I don't know how else to get a unique hash since the instances rotate around and reuse the same memory
+		auto hash = PointerHash(SwarmKineManager, ++instances_generated);
+		FSkeletonKey NewInstanceKey = FSkeletonKey(hash);
+		SwarmKineManager->AddToMap(NewInstanceId, NewInstanceKey);
+		return NewInstanceKey;
+	}
+
+	//makes the instance's barrage body, and hands it to the shadow transforms and the ticklites. the key's either fresh
+	//from MintKey or a parked one coming back, already mapped to this instance either way.
+	//everything in here is per projectile. anything that can be done once belongs in the callers.
+	FSkeletonKey BindNewInstance(FPrimitiveInstanceId NewInstanceId, FSkeletonKey NewInstanceKey, const FTransform& WorldTransform, const FVector3d& MuzzleVelocity, const uint16_t Layer, bool IsSensor)
+	{
+		InstanceByKey.Add(NewInstanceKey, {NewInstanceId, WorldTransform.GetScale3D(),
+			Snapshots.IsValid() ? Snapshots->Allocate(NewInstanceKey) : INDEX_NONE});
+
+		MakeBody(NewInstanceKey, WorldTransform, MuzzleVelocity, Layer, IsSensor);
+
+		TransformDispatch->RegisterObjectToShadowTransform(NewInstanceKey, SwarmKineManager);
+		
+		return NewInstanceKey;
+	}
+
+	//the body and the lifespan resolver. either thread, see CreateSimBody.
+	void MakeBody(const FSkeletonKey NewInstanceKey, const FTransform& WorldTransform, const FVector3d& MuzzleVelocity, const uint16_t Layer, bool IsSensor)
+	{
+		// TODO: can't use the BarrageColliderBase set of types, so in-lining the barrage setup code. Is this what we want long-term?
+		auto params = FBarrageBounder::GenerateBoxBounds(WorldTransform.GetLocation(), InstanceExtents.X, InstanceExtents.Y, InstanceExtents.Z,
+			FVector3d(0, 0, InstanceExtents.Z/2));
+
+		FBLet MyBarrageBody = Physics->CreatePrimitive(params, NewInstanceKey, Layer, IsSensor);
+		FBarragePrimitive::SetVelocity(MuzzleVelocity, MyBarrageBody);
+
+		MyDispatch->REGISTER_PROJECTILE_FINAL_TICK_RESOLVER(100, NewInstanceKey);
+	}
 };
\ No newline at end of file
@@ -4,30 +4,62 @@
 #include "PhysicsTypes/BarragePlayerAgent.h"
 #include "ArtilleryBPLibs.generated.h"
 
+//every world runs its own artillery, so a node finds its subsystems through whatever it was called from.
+template <typename Subsystem>
+Subsystem* ArtilleryForWorld(const UObject* WorldContextObject)
+{
+	const UWorld* World = WorldContextObject ? WorldContextObject->GetWorld() : nullptr;
+	return World ? World->GetSubsystem<Subsystem>() : nullptr;
+}
+
 UCLASS(meta=(ScriptName="InputSystemLibrary"))
 class ARTILLERYRUNTIME_API UInputECSLibrary : public UBlueprintFunctionLibrary
 {
 	GENERATED_BODY()
 public:
-	static void GetHistoricalInputs(TArray<FArtilleryShell>& Inputs, int Count)
+	static void GetHistoricalInputs(const UObject* WorldContextObject, TArray<FArtilleryShell>& Inputs, int Count)
 	{
-		auto ptr = UCanonicalInputStreamECS::SelfPtr;
+		auto ptr = ArtilleryForWorld<UCanonicalInputStreamECS>(WorldContextObject);
 		if(ptr)
 		{
 			auto streamkey = ptr->GetStreamForPlayer(PlayerKey::CABLE);
 			auto sptr = ptr->GetStream(streamkey);
-			for(int i = 0; i <= Count; ++i)
+			if(!sptr)
 			{
-				auto input =  sptr.Get()->peek( sptr->GetHighestGuaranteedInput()-i);
-				Inputs.Add(input.has_value() ? input.value() : FArtilleryShell());
+				return;
 			}
+			//newest first, Count + 1 of them, defaulted where the history doesn't reach.
+			const FArtilleryInputView View = sptr->View(sptr->GetHighestGuaranteedInput(), Count + 1);
+			const int32 Start = Inputs.Num();
+			Inputs.Reserve(Start + Count + 1);
+			for(int i = View.Num() - 1; i >= 0; --i)
+			{
+				Inputs.Add(View[i]);
+			}
+			Inputs.SetNum(Start + Count + 1);
 		}
 	}
 
+	//the same window as GetHistoricalInputs, unpacked into a batch instead of copied out shell by shell. oldest first.
+	static bool GetHistoricalInputBatch(const UObject* WorldContextObject, FArtilleryInputBatch& Batch, int Count)
+	{
+		auto ptr = ArtilleryForWorld<UCanonicalInputStreamECS>(WorldContextObject);
+		if(ptr)
+		{
+			auto sptr = ptr->GetStream(ptr->GetStreamForPlayer(PlayerKey::CABLE));
+			if(sptr)
+			{
+				Batch.Decode(sptr->View(sptr->GetHighestGuaranteedInput(), Count + 1));
+				return Batch.Num() > 0;
+			}
+		}
+		return false;
+	}
+
 	UFUNCTION(BlueprintPure, meta = (ScriptName = "Get15PlayerInputs", DisplayName = "Get Last 15 of Local Player's Inputs", WorldContext = "WorldContextObject", HidePin = "WorldContextObject"),  Category="Artillery|Inputs")
 	static void K2_Get15LocalHistoricalInputs(UObject* WorldContextObject, TArray<FArtilleryShell> &Inputs)
 	{
-		GetHistoricalInputs(Inputs, 15);
+		GetHistoricalInputs(WorldContextObject, Inputs, 15);
 	}
 };
 
@@ -36,42 +68,81 @@ class ARTILLERYRUNTIME_API UArtilleryLibrary : public UBlueprintFunctionLibrary
 {
 	GENERATED_BODY()
 public:
-	UFUNCTION(BlueprintCallable, meta = (ScriptName = "GetAttribute", DisplayName = "Get Attribute Of", ExpandBoolAsExecs="bFound"), Category="Artillery|Attributes")
-	static float K2_GetAttrib(FSkeletonKey Owner, E_AttribKey Attrib, bool& bFound)
+	UFUNCTION(BlueprintCallable, meta = (ScriptName = "GetAttribute", DisplayName = "Get Attribute Of", WorldContext = "WorldContextObject", HidePin = "WorldContextObject", ExpandBoolAsExecs="bFound"), Category="Artillery|Attributes")
+	static float K2_GetAttrib(UObject* WorldContextObject, FSkeletonKey Owner, E_AttribKey Attrib, bool& bFound)
 	{
 		bFound = false;
-		return implK2_GetAttrib(Owner,Attrib, bFound);
+		return implK2_GetAttrib(WorldContextObject, Owner,Attrib, bFound);
 	}
 
-	static float implK2_GetAttrib(FSkeletonKey Owner, E_AttribKey Attrib, bool& bFound)
+	//on the game thread, this reads the published state, so every read in a frame agrees. abilities running on the
+	//sim side need the live value, so they still go to the attribute itself.
+	static float implK2_GetAttrib(const UObject* WorldContextObject, FSkeletonKey Owner, E_AttribKey Attrib, bool& bFound)
 	{
 		
 		bFound = false;
-		if(UArtilleryDispatch::SelfPtr)
+		if(UArtilleryDispatch* Dispatch = ArtilleryForWorld<UArtilleryDispatch>(WorldContextObject))
 		{
-			if(UArtilleryDispatch::SelfPtr->GetAttrib( Owner, Attrib))
+			if(IsInGameThread())
+			{
+				float Value = NAN;
+				bFound = Dispatch->GetPublishedSimState().GetAttribute(Owner, Attrib, Value);
+				return bFound ? Value : NAN;
+			}
+			if(AttrPtr Found = Dispatch->GetAttrib( Owner, Attrib))
 			{
 				bFound = true;
-				return UArtilleryDispatch::SelfPtr->GetAttrib( Owner, Attrib)->GetCurrentValue();
+				return Found->GetCurrentValue();
 			}
 		}
 		return NAN;
 	}
-	UFUNCTION(BlueprintCallable, meta = (ScriptName = "GetRelatedKey", DisplayName = "Get Related Key From", ExpandBoolAsExecs="bFound"), Category="Artillery|Keys")
-	static FSkeletonKey K2_GetIdentity(FSkeletonKey Owner, E_IdentityAttrib Attrib, bool& bFound)
+	//for hud and cosmetics. instead of reading an attribute every frame, get told when it moves.
+	UFUNCTION(BlueprintCallable, meta = (ScriptName = "WatchAttribute", DisplayName = "Watch Attribute Of", WorldContext = "WorldContextObject", HidePin = "WorldContextObject"), Category="Artillery|Attributes")
+	static void K2_WatchAttrib(UObject* WorldContextObject, FSkeletonKey Owner, E_AttribKey Attrib, FArtilleryAttributeChanged OnChanged)
+	{
+		if(UArtilleryDispatch* Dispatch = ArtilleryForWorld<UArtilleryDispatch>(WorldContextObject))
+		{
+			Dispatch->WatchAttribute(Owner, Attrib, OnChanged);
+		}
+	}
+
+	UFUNCTION(BlueprintCallable, meta = (ScriptName = "UnwatchAttribute", DisplayName = "Stop Watching Attribute Of", WorldContext = "WorldContextObject", HidePin = "WorldContextObject"), Category="Artillery|Attributes")
+	static void K2_UnwatchAttrib(UObject* WorldContextObject, FSkeletonKey Owner, E_AttribKey Attrib, FArtilleryAttributeChanged OnChanged)
+	{
+		if(UArtilleryDispatch* Dispatch = ArtilleryForWorld<UArtilleryDispatch>(WorldContextObject))
+		{
+			Dispatch->UnwatchAttribute(Owner, Attrib, OnChanged);
+		}
+	}
+
+	UFUNCTION(BlueprintPure, meta = (ScriptName = "GetGunDefinitionID", DisplayName = "Get Gun Definition ID"), Category="Artillery|Keys")
+	static FString K2_GetGunDefinitionID(const FGunKey& Gun)
+	{
+		return Gun.GetGunDefinitionID();
+	}
+
+	UFUNCTION(BlueprintCallable, meta = (ScriptName = "GetRelatedKey", DisplayName = "Get Related Key From", WorldContext = "WorldContextObject", HidePin = "WorldContextObject", ExpandBoolAsExecs="bFound"), Category="Artillery|Keys")
+	static FSkeletonKey K2_GetIdentity(UObject* WorldContextObject, FSkeletonKey Owner, E_IdentityAttrib Attrib, bool& bFound)
 	{
 		
 		bFound = false;
-		return implK2_GetIdentity(Owner, Attrib, bFound);
+		return implK2_GetIdentity(WorldContextObject, Owner, Attrib, bFound);
 	}
 	
-	static FSkeletonKey implK2_GetIdentity(FSkeletonKey Owner, E_IdentityAttrib Attrib, bool& bFound)
+	static FSkeletonKey implK2_GetIdentity(const UObject* WorldContextObject, FSkeletonKey Owner, E_IdentityAttrib Attrib, bool& bFound)
 	{
 		
 		bFound = false;
-		if(UArtilleryDispatch::SelfPtr)
+		if(UArtilleryDispatch* Dispatch = ArtilleryForWorld<UArtilleryDispatch>(WorldContextObject))
 		{
-			auto ident = UArtilleryDispatch::SelfPtr->GetIdent( Owner, Attrib);
+			if(IsInGameThread())
+			{
+				FSkeletonKey Related;
+				bFound = Dispatch->GetPublishedSimState().GetIdentity(Owner, Attrib, Related);
+				return Related;
+			}
+			auto ident = Dispatch->GetIdent( Owner, Attrib);
 			if(ident)
 			{
 				bFound = true;
@@ -93,7 +164,7 @@ public:
 			auto key = ptr->ActorByStream(streamkey);
 			if(key)
 			{
-				return  implK2_GetIdentity(key, Attrib, bFound);
+				return  implK2_GetIdentity(WorldContextObject, key, Attrib, bFound);
 			}
 		}
 		bFound = false;
@@ -110,7 +181,7 @@ public:
 		{
 			if(FSkeletonKey key = ptr->GetObjectKey())
 			{
-				return implK2_GetAttrib(key, Attrib, bFound);
+				return implK2_GetAttrib(Actor, key, Attrib, bFound);
 			}
 		}
 		bFound = false;
@@ -128,7 +199,7 @@ public:
 			auto key = ptr->ActorByStream(streamkey);
 			if(key)
 			{
-				return  implK2_GetAttrib(key, Attrib, bFound);
+				return  implK2_GetAttrib(WorldContextObject, key, Attrib, bFound);
 			}
 		}
 		bFound = false;
@@ -136,26 +207,32 @@ public:
 	}
 	//DEPRECATED
 	//TODO: This needs to be replaced by GetPlayerBarrageAgent(PlayerKey)
-	static TObjectPtr<UBarragePlayerAgent> GetLocalPlayerBarrageAgent()
+	static TObjectPtr<UBarragePlayerAgent> GetLocalPlayerBarrageAgent(const UObject* WorldContextObject)
 	{
-		if (UTransformDispatch::SelfPtr && UArtilleryDispatch::SelfPtr && UCanonicalInputStreamECS::SelfPtr)
+		UTransformDispatch* Transforms = ArtilleryForWorld<UTransformDispatch>(WorldContextObject);
+		UCanonicalInputStreamECS* InputECS = ArtilleryForWorld<UCanonicalInputStreamECS>(WorldContextObject);
+		UArtilleryDispatch* Dispatch = ArtilleryForWorld<UArtilleryDispatch>(WorldContextObject);
+		if (Transforms && InputECS && Dispatch)
 		{
-			if (CurrentPlayerAgent && CurrentPlayerAgent->IsValidLowLevelFast() && CurrentPlayerAgent->GetOwner()->
-				IsActorTickEnabled())
+			//cached on the world's dispatch, and weakly, so a collected agent just reads as null here.
+			UBarragePlayerAgent* Cached = Dispatch->GetCachedLocalPlayerAgent();
+			const AActor* CachedOwner = Cached ? Cached->GetOwner() : nullptr;
+			if (CachedOwner && CachedOwner->IsActorTickEnabled())
 			{
-				return CurrentPlayerAgent;
+				return Cached;
 			}
 
-			CurrentPlayerAgent = nullptr;
-			auto local = UCanonicalInputStreamECS::SelfPtr->GetStreamForPlayer(PlayerKey::CABLE);
+			Dispatch->CacheLocalPlayerAgent(nullptr);
+			auto local = InputECS->GetStreamForPlayer(PlayerKey::CABLE);
 			if (local != 0)
 			{
-				auto playerkey = UCanonicalInputStreamECS::SelfPtr->ActorByStream(local);
-				TObjectPtr<AActor> SecretName = UTransformDispatch::SelfPtr->GetAActorByObjectKey(playerkey).Get();
+				auto playerkey = InputECS->ActorByStream(local);
+				TObjectPtr<AActor> SecretName = Transforms->GetAActorByObjectKey(playerkey).Get();
 				if (SecretName)
 				{
-					CurrentPlayerAgent = SecretName->GetComponentByClass<UBarragePlayerAgent>();
-					return CurrentPlayerAgent;
+					UBarragePlayerAgent* Found = SecretName->GetComponentByClass<UBarragePlayerAgent>();
+					Dispatch->CacheLocalPlayerAgent(Found);
+					return Found;
 				}
 			}
 		}
@@ -164,50 +241,52 @@ public:
 
 	//DEPRECATED
 	//TODO: This needs to be replaced by GetPlayerVectors(Forward, Right, PlayerKey)
-	static void GetLocalPlayerVectors(FVector& Forward, FVector& Right)
+	static void GetLocalPlayerVectors(const UObject* WorldContextObject, FVector& Forward, FVector& Right)
 	{
-		if(UTransformDispatch::SelfPtr && UArtilleryDispatch::SelfPtr && UCanonicalInputStreamECS::SelfPtr)
+		auto local = GetLocalPlayerBarrageAgent(WorldContextObject);
+		if(local && local->IsValidLowLevelFast())
 		{
-			auto local = GetLocalPlayerBarrageAgent();
-			if(local && local->IsValidLowLevelFast())
-			{
-				Forward = local->Chaos_LastGameFrameForwardVector();
-				Right = local->Chaos_LastGameFrameRightVector();
-			}
+			Forward = local->Chaos_LastGameFrameForwardVector();
+			Right = local->Chaos_LastGameFrameRightVector();
 		}
 	}
 
-	UFUNCTION(BlueprintPure, meta = (ScriptName = "GetPlayerVectors", DisplayName = "Get Local Player's Attribute"),  Category="Artillery|Character")
-	static void K2_GetLocalPlayerVectors(FVector& Forward, FVector& Right)
+	UFUNCTION(BlueprintPure, meta = (ScriptName = "GetPlayerVectors", DisplayName = "Get Local Player's Attribute", WorldContext = "WorldContextObject", HidePin = "WorldContextObject"),  Category="Artillery|Character")
+	static void K2_GetLocalPlayerVectors(UObject* WorldContextObject, FVector& Forward, FVector& Right)
 	{
-		GetLocalPlayerVectors(Forward, Right);
+		GetLocalPlayerVectors(WorldContextObject, Forward, Right);
 	}
 
-	static void SimpleEstimator(FVector& Forwardish, double Counter = 15)
+	static void SimpleEstimator(const UObject* WorldContextObject, FVector& Forwardish, double Counter = 15)
 	{
 		FVector Right;
-		GetLocalPlayerVectors(Forwardish, Right);
-		TArray<FArtilleryShell> In;
-		UInputECSLibrary::GetHistoricalInputs(In, Counter);
+		GetLocalPlayerVectors(WorldContextObject, Forwardish, Right);
+		FArtilleryInputBatch& In = EstimatorScratch();
+		if(!UInputECSLibrary::GetHistoricalInputBatch(WorldContextObject, In, Counter))
+		{
+			return;
+		}
 		double accumulateX = 0;
 		double accumulateY = 0;
-		for(auto& shell : In)
+		for(int i = In.Num() - 1; i >= 0; --i)
 		{
-			accumulateX += shell.GetStickLeftX();
-			accumulateY += shell.GetStickLeftY();
+			accumulateX += In.LeftX[i];
+			accumulateY += In.LeftY[i];
 		}
 		accumulateX = accumulateX/Counter;
 		accumulateY = accumulateY/Counter;
 		//for serious work, replace this.
-		accumulateX += In[0].GetStickLeftX();
-		accumulateX += In[0].GetStickLeftX();
-		accumulateX += In[0].GetStickLeftX();
-		accumulateY += In[0].GetStickLeftY();
-		accumulateY += In[0].GetStickLeftY();
-		accumulateY += In[0].GetStickLeftY();
+		const float NewestX = In.LeftX.Last();
+		const float NewestY = In.LeftY.Last();
+		accumulateX += NewestX;
+		accumulateX += NewestX;
+		accumulateX += NewestX;
+		accumulateY += NewestY;
+		accumulateY += NewestY;
+		accumulateY += NewestY;
 		accumulateX = accumulateX/4.0;
 		accumulateY = accumulateY/4.0;
-		auto bind = GetLocalPlayerBarrageAgent();
+		auto bind = GetLocalPlayerBarrageAgent(WorldContextObject);
 		if(bind)
 		{
 			auto moveX = accumulateX * bind->Acceleration * Right;
@@ -216,12 +295,14 @@ public:
 		}
 	}
 
-	UFUNCTION(BlueprintPure, meta = (ScriptName = "GetPlayerDirectionEstimator", DisplayName = "Get Local Player's Direction Estimator"),  Category="Artillery|Character")
-	static void K2_GetPlayerDirectionEstimator(FVector& Forward)
+	UFUNCTION(BlueprintPure, meta = (ScriptName = "GetPlayerDirectionEstimator", DisplayName = "Get Local Player's Direction Estimator", WorldContext = "WorldContextObject", HidePin = "WorldContextObject"),  Category="Artillery|Character")
+	static void K2_GetPlayerDirectionEstimator(UObject* WorldContextObject, FVector& Forward)
 	{
-		 SimpleEstimator(Forward, 15);
+		 SimpleEstimator(WorldContextObject, Forward, 15);
 	}
 
 private:
-	static inline TObjectPtr<UBarragePlayerAgent> CurrentPlayerAgent = nullptr;
+	//per thread, since the estimator runs from whichever lane its match is on. the thread local lives in the cpp, msvc
+	//won't let an exported class hold one.
+	static FArtilleryInputBatch& EstimatorScratch();
 };
\ No newline at end of file
@@ -7,12 +7,16 @@
 #include "UBristleconeWorldSubsystem.h"
 #include "UCablingWorldSubsystem.h"
 #include "ArtilleryCommonTypes.h"
+#include "FGunDefinitionBlob.h"
+#include "FTransformSnapshotBuffer.h"
+#include "FPublishedSimState.h"
 #include "Containers/TripleBuffer.h"
 #include "FArtilleryBusyWorker.h"
 #include "LocomotionParams.h"
 #include "ConservedAttribute.h"
 #include "FArtilleryTicklitesThread.h"
 #include "KeyCarry.h"
+#include "UArtilleryAbilityMinimum.h"
 #include "TransformDispatch.h"
 #include "PhysicsTypes/BarragePlayerAgent.h"
 #include "ArtilleryDispatch.generated.h"
@@ -44,13 +48,49 @@
  * Iris does normal replication on a slow cadence as a fall back and to provide attribute sync reassurances.
  */
 struct FArtilleryGun;
+class UArtilleryPerActorAbilityMinimum;
+class AInstancedMeshManager;
+
+//fired on the game thread when a watched attribute changes. see UArtilleryDispatch::WatchAttribute.
+DECLARE_DYNAMIC_DELEGATE_ThreeParams(FArtilleryAttributeChanged, FSkeletonKey, Owner, E_AttribKey, Attrib, float, Value);
+
+//one of these per gun definition, shared by every gun of that definition that opts in. rooted once, by the dispatch.
+struct FArtilleryAbilitySet
+{
+	UArtilleryPerActorAbilityMinimum* Prefire = nullptr;
+	UArtilleryPerActorAbilityMinimum* PrefireCosmetic = nullptr;
+	UArtilleryPerActorAbilityMinimum* Fire = nullptr;
+	UArtilleryPerActorAbilityMinimum* FireCosmetic = nullptr;
+	UArtilleryPerActorAbilityMinimum* PostFire = nullptr;
+	UArtilleryPerActorAbilityMinimum* PostFireCosmetic = nullptr;
+	UArtilleryPerActorAbilityMinimum* FailedFireCosmetic = nullptr;
+
+	template <typename Fn>
+	void ForEach(Fn&& Visit) const
+	{
+		for (UArtilleryPerActorAbilityMinimum* Phase : {Prefire, PrefireCosmetic, Fire, FireCosmetic, PostFire, PostFireCosmetic, FailedFireCosmetic})
+		{
+			Visit(Phase);
+		}
+	}
+};
+
 namespace Arty
 {
 	DECLARE_MULTICAST_DELEGATE(OnArtilleryActivated);
+
+	//game thread. the earliest sim tick a predicted remote input turned out wrong on, since the last time this fired.
+	//this is where a rollback would resim from. there's no rollback yet, so for now it's for whoever wants to know.
+	DECLARE_MULTICAST_DELEGATE_OneParam(OnArtilleryInputDiverged, uint64);
 	
 	DECLARE_DELEGATE_TwoParams(FArtilleryFireGunFromDispatch,
 		TSharedPtr<FArtilleryGun> Gun,
 		bool InputAlreadyUsedOnce);
+
+	//cosmetic half of a gun that resolves on the busy worker. Fired is false for a shot the sim refused.
+	DECLARE_DELEGATE_TwoParams(FArtilleryCueGunFromDispatch,
+		TSharedPtr<FArtilleryGun> Gun,
+		bool Fired);
 	
 	//returns true if-and-only-if the duration of the input intent was exhausted.
 	DECLARE_DELEGATE_RetVal_FourParams(bool,
@@ -73,33 +113,48 @@ class ARTILLERYRUNTIME_API UArtilleryDispatch : public UTickableWorldSubsystem
 	friend class FArtilleryTicklitesWorker<UArtilleryDispatch>;
 	friend class UCanonicalInputStreamECS;
 	friend class UArtilleryLibrary;
-protected:
-	static inline UArtilleryDispatch* SelfPtr = nullptr;
 
 public:
 	
 	OnArtilleryActivated BindToArtilleryActivated;
+	OnArtilleryInputDiverged BindToInputDiverged;
+
+	//Busy worker. a misprediction came back. only the earliest tick is kept until the game thread hands it on.
+	void ReportInputDivergence(uint64 SimTickDiverged)
+	{
+		uint64 Earliest = EarliestInputDivergence.load(std::memory_order_relaxed);
+		while (SimTickDiverged < Earliest && !EarliestInputDivergence.compare_exchange_weak(Earliest, SimTickDiverged, std::memory_order_relaxed))
+		{
+		}
+		InputDivergences.fetch_add(1, std::memory_order_relaxed);
+	}
+	//either thread. how many frames turned up at least one misprediction, this match. for stats.
+	uint32 GetInputDivergenceCount() const
+	{
+		return InputDivergences.load(std::memory_order_relaxed);
+	}
 	
 	inline ArtilleryTime GetShadowNow()
 const
 	{
 		return ArtilleryAsyncWorldSim.TickliteNow;
 	};
+	//Busy worker only. counts real ticks, where shadow time is microseconds. see FArtilleryBusyWorker::GetSimTick.
+	inline uint64 GetSimTick() const
+	{
+		return ArtilleryAsyncWorldSim.GetSimTick();
+	}
 	void REGISTER_ENTITY_FINAL_TICK_RESOLVER(ActorKey Self);
 	void REGISTER_PROJECTILE_FINAL_TICK_RESOLVER(uint32 MaximumLifespanInTicks, FSkeletonKey Self);
 	void REGISTER_GUN_FINAL_TICK_RESOLVER(FGunKey Self);
 	void INITIATE_JUMP_TIMER(FSkeletonKey Self);
 
-	//Forwarding for the TickliteThread.
+	//Forwarding for the TickliteThread, and for guns that resolve on the busy worker.
 	TOptional<FTransform> GetTransformShadowByObjectKey(FSkeletonKey Target, ArtilleryTime Now)
 	{
-		if(GetWorld())
+		if(TransformECSPillarCache)
 		{
-			auto TransformECSPillar = GetWorld()->GetSubsystem<UTransformDispatch>();
-			if(TransformECSPillar)
-			{
-				return	TransformECSPillar->CopyOfTransformByObjectKey(Target);
-			}
+			return	TransformECSPillarCache->CopyOfTransformByObjectKey(Target);
 		}
 		return TOptional<FTransform>();
 	}
@@ -117,21 +172,6 @@ const
 		return FBLet();
 	}
 
-	//forwarding for TickliteThread
-	//TEMPORARILY REVIVED! HAHAHAHAHA! Speed over elegaerngz
-	bool ApplyShadowTransforms()
-	{
-		if(GetWorld())
-		{
-			auto TransformECSPillar = GetWorld()->GetSubsystem<UTransformDispatch>();
-			if(TransformECSPillar)
-			{
-				return	TransformECSPillar->ApplyTransformUpdates<TSharedPtr<TransformUpdatesForGameThread>>(TransformUpdateQueue);
-			}
-		}
-		return false;
-	}
-	
 	//Executes necessary preconfiguration for threads owned by this dispatch. Likely going to be factored into the
 	//dispatch API so that we can use stronger type guarantees throughout our codebase.
 	//Called FROM the thread being set up.
@@ -157,6 +197,10 @@ protected:
 	//TODO: assess if this needs to be a multimap. I think it needs to NOT be.
 	TSharedPtr< TMap<FGunKey, FArtilleryFireGunFromDispatch>> GunToFiringFunctionMapping;
 	TSharedPtr<BufferedEvents> RequestorQueue_Abilities_TripleBuffer;
+	//guns that resolve on the busy worker skip the mapping above entirely, and only show up here as cues.
+	TSharedPtr< TMap<FGunKey, FArtilleryCueGunFromDispatch>> GunToCueFunctionMapping;
+	//single producer (busy worker), single consumer (game thread tick).
+	TSharedPtr<FireCueQueue> FireCues;
 
 	//This is more straightforward than the guns problem.
 	//We can actually map this quite directly.
@@ -164,9 +208,76 @@ protected:
 	
 	// NOTTODO: It's built!
 	TSharedPtr<TMap<FSkeletonKey, AttrMapPtr>> AttributeSetToDataMapping;
+	//the busy worker's copy of the above, kept the same way as SimGunByKey. GetAttrib reads it off the game thread.
+	TMap<FSkeletonKey, AttrMapPtr> SimAttributeSetToDataMapping;
+	TQueue<TPair<FSkeletonKey, AttrMapPtr>, EQueueMode::Spsc> AttributeSetChanges;
 	
 	TSharedPtr<TMap<FSkeletonKey, IdMapPtr>> IdentSetToDataMapping;
+	//the game thread's copy of the above. see FPublishedSimState.
+	TSharedPtr<FPublishedSimState> PublishedSimState;
+	//game thread only. everyone watching each (key, attribute).
+	TMap<TPair<FSkeletonKey, E_AttribKey>, TArray<FArtilleryAttributeChanged>> AttributeWatchers;
+	//fires the watchers for whatever changed up to the tick we just latched.
+	void DispatchAttributeChanges();
 	TSharedPtr<TransformUpdatesForGameThread> TransformUpdateQueue;
+	//game thread only, both ends. whatever isn't an instanced projectile goes back through the transform dispatch via this.
+	TSharedPtr<TransformUpdatesForGameThread> PassthroughTransforms;
+	//single producer (busy worker), single consumer (game thread). the pump, minus everything that went into a snapshot.
+	TSharedPtr<TransformUpdatesForGameThread> ForwardedTransforms;
+	TSharedPtr<FTransformSnapshotBuffer> TransformSnapshots;
+	//managers with instance transforms waiting on a flush this tick.
+	TArray<AInstancedMeshManager*> InstanceManagersToFlush;
+	//everyone who reads snapshots at render time. pruned as they go away.
+	TArray<TWeakObjectPtr<AInstancedMeshManager>> SnapshotReaders;
+	//splits the pump: instanced projectiles are batched per mesh manager, everything else goes through as before.
+	void ApplyTransformUpdatesBatched(UTransformDispatch* TransformECS);
+public:
+	//Ticklites worker, before calculate. fills Out with the shadow location of each key, in order, and Found with
+	//whether it had one. Out is left empty if there's no transform dispatch to ask.
+	void GatherShadowLocations(TConstArrayView<FSkeletonKey> Keys, TArray<FVector3d>& Out, TBitArray<>& Found);
+	//Game thread. puts the key in the ticklites' spatial grid. see FArtillerySpatialGrid.
+	void RegisterForProximityQueries(FSkeletonKey Key)
+	{
+		ArtilleryTicklitesWorker_LockstepToWorldSim.RequestSpatialRegistration(Key);
+	}
+	//Ticklites worker, between calculate and apply. every sphere cast asked for this tick, in order, on the calling
+	//thread, since that's the one holding a barrage feed. Results must already be at least as long as Queries.
+	void RunShapeCasts(TConstArrayView<FShapeCastQuery> Queries, TArray<TSharedPtr<FHitResult>>& Results);
+	//Busy worker, right after the step. drains the pump into the snapshots and forwards whatever isn't snapshotted.
+	void PublishTransformSnapshots();
+	//Ticklites worker, after apply.
+	void PublishSimState()
+	{
+		PublishedSimState->Publish();
+	}
+	//Game thread. attributes and identities as of the last tick the game thread latched.
+	const FPublishedSimState& GetPublishedSimState() const
+	{
+		return *PublishedSimState;
+	}
+	//Game thread. OnChanged fires with the current value once the sim has seen the watch, and then only when the value
+	//moves. watching something that isn't registered yet is fine; it reports once it shows up.
+	void WatchAttribute(FSkeletonKey Owner, E_AttribKey Attrib, const FArtilleryAttributeChanged& OnChanged);
+	void UnwatchAttribute(FSkeletonKey Owner, E_AttribKey Attrib, const FArtilleryAttributeChanged& OnChanged);
+	TSharedPtr<FTransformSnapshotBuffer> GetTransformSnapshots() const
+	{
+		return TransformSnapshots;
+	}
+	void RegisterSnapshotReader(AInstancedMeshManager* Reader)
+	{
+		SnapshotReaders.Add(Reader);
+	}
+	//any thread. the local player's agent, once someone's found it, for as long as it's alive.
+	UBarragePlayerAgent* GetCachedLocalPlayerAgent() const
+	{
+		FScopeLock Lock(&LocalPlayerAgentLock);
+		return LocalPlayerAgent.Get();
+	}
+	void CacheLocalPlayerAgent(UBarragePlayerAgent* Agent)
+	{
+		FScopeLock Lock(&LocalPlayerAgentLock);
+		LocalPlayerAgent = Agent;
+	}
 public:
 	virtual void PostInitialize() override;
 
@@ -181,25 +292,54 @@ protected:
 	FSkeletonKey Target, ArtilleryTime Now) const;
 	TSharedPtr<BufferedMoveEvents> RequestorQueue_Locomos_TripleBuffer;
 
-	static inline long long TotalFirings = 0; //2024 was rough.
+	long long TotalFirings = 0; //2024 was rough.
 	virtual void Tick(float DeltaTime) override;
 	virtual TStatId GetStatId() const override;
+	//interns the id, then the same as below. hang onto FGunDefinitionIds::Intern's index and use that one where you can.
 	FGunKey GetGun(FString GunDefinitionID, ActorKey ProbableOwner);
+	//the equip path. no strings and no locks for any definition that was prewarmed.
+	FGunKey GetGun(uint32 GunDefinitionIndex, ActorKey ProbableOwner);
+	//level load only. builds Count pooled guns of a definition so GetGun can hand them out without allocating.
+	void PrewarmGuns(const FString& GunDefinitionID, int32 Count);
+	//by interned definition index. filled by PrewarmGuns, or the first time GetGun sees a definition.
+	TMap<uint32, FGunDefinitionKeyParts> DefinitionKeyParts;
 	//fully specifying the type is necessary to prevent spurious warnings in some cases.
 	TSharedPtr<TCircularQueue<std::pair<FGunKey, ArtilleryTime>>> ActionsToOrder;
 	//These two are the backbone of the Artillery gun lifecycle.
 	TSharedPtr< TMap<FGunKey, TSharedPtr<FArtilleryGun>>> GunByKey;
-	TMultiMap<FString, TSharedPtr<FArtilleryGun>> PooledGuns;
+	//the busy worker's copy of GunByKey. the game thread never touches the map itself, it queues every add and remove
+	//(a null gun) to GunByKeyChanges, and the busy worker replays them before it resolves anything.
+	TMap<FGunKey, TSharedPtr<FArtilleryGun>> SimGunByKey;
+	mutable TQueue<TPair<FGunKey, TSharedPtr<FArtilleryGun>>, EQueueMode::Spsc> GunByKeyChanges;
+	//keyed by interned definition index. see FGunDefinitionIds.
+	TMultiMap<uint32, TSharedPtr<FArtilleryGun>> PooledGuns;
+	//keyed the same way. see GetSharedAbilities.
+	TMap<uint32, FArtilleryAbilitySet> SharedAbilitySets;
+	//keyed the same way. see GetAttributeTemplate.
+	TMap<uint32, TSharedPtr<const TMap<AttribKey, double>>> AttributeTemplates;
+	//looked up once at begin play. the worker reads it every tick the spatial grid is used, see GatherShadowLocations.
+	UPROPERTY()
+	TObjectPtr<UTransformDispatch> TransformECSPillarCache;
+	//same, for the shape casts. see RunShapeCasts.
+	UPROPERTY()
+	TObjectPtr<UBarrageDispatch> PhysicsECSPillarCache;
 
 	
 	/**
-	 * Wil hold the configuration for the gun definitions
+	 * Wil hold the configuration for the gun definitions, but only in dev, and only when there's no compiled blob.
 	 */
+	UPROPERTY()
 	TObjectPtr<UDataTable> GunDefinitionsManifest;
-	//TODO: This is a dummy function and should be replaced NLT 10/20/24.
-	//It loads from the PROJECT directory. This cannot ship, but will work for all purposes at the moment.
+	//maps the compiled blob, FGunDefinitionBlob::Get, if no world has yet. false if there isn't one or it's stale, in which case dev builds fall back to the table.
 	//Note: https://www.reddit.com/r/unrealengine/comments/160mjkx/how_reliable_and_scalable_are_the_data_tables/
-	void LoadGunData();
+	bool LoadGunData();
+	void PrewarmFromGunData();
+	//the compiled record for a definition, or null if the blob doesn't have one. game thread.
+	const FGunDefinitionRecord* FindGunDefinition(uint32 GunDefinitionIndex) const;
+#if !UE_BUILD_SHIPPING
+	//seconds since we last looked for a recompiled blob.
+	float SinceGunDataCheck = 0;
+#endif
 	
 	TSharedPtr<TCircularQueue<std::pair<FGunKey, ArtilleryTime>>> ActionsToReconcile;
 
@@ -211,6 +351,10 @@ protected:
 	//In fact, it's pretty common to this day, with Unity also using a similar model.
 	//However, our particular design is running fast relative to most games except quake.
 	void RunGuns();
+	//called from the busy worker. see the definition.
+	void ResolveGunsOnSimThread(EventBuffer& Requested);
+	//Busy worker, first thing each tick. replays the game thread's gun and attribute registrations onto our copies.
+	void TakeSimMappingChanges();
 	void RunLocomotions();
 	void RunGunFireTimers();
 	void CheckFutures();
@@ -227,39 +371,73 @@ protected:
 
 public:
 	typedef FArtilleryTicklitesWorker<UArtilleryDispatch> FTicklitesWorker;
-	struct TL_ThreadedImpl 
+	struct ARTILLERYRUNTIME_API TL_ThreadedImpl 
 	{
 		//Each class generated gets a unique static. Each kind of dispatcher will get a unique class.
-		//TODO: If you run more than one of the parent threads, this gets unsafe. We don't so...
+		//it's per thread, so one process can run as many matches as it likes. the ticklites worker points it at itself
+		//for each half of its tick, on whichever lane it's on, and it's null everywhere else. that's fine, since impls
+		//only touch it from their TICKLITE_ functions, but it does mean you can't use it while constructing one.
 		//As is, it saves a huge amount of memory and indirection costs.
-		static inline FTicklitesWorker* ADispatch = nullptr;
+		//the thread local itself lives in ArtilleryDispatch.cpp. msvc won't export a thread_local static member.
+		static FTicklitesWorker* ADispatch();
+		static void SetADispatch(FTicklitesWorker* Worker);
 
-		TL_ThreadedImpl()
+		//points ADispatch at a worker for as long as it's in scope, then puts back whatever was there.
+		struct FBindScope
 		{
-			if(ADispatch == nullptr)
+			explicit FBindScope(FTicklitesWorker* Worker) : Prior(ADispatch())
+			{
+				SetADispatch(Worker);
+			}
+			~FBindScope()
 			{
-				throw; // dawg, you tryin' allocate shit against a thread that ain' there.
+				SetADispatch(Prior);
 			}
+			FTicklitesWorker* Prior;
+		};
+
+		TL_ThreadedImpl()
+		{
 		}
 	
 		ArtilleryTime GetShadowNow()
 		{
-			return ADispatch->GetShadowNow();
+			return ADispatch()->GetShadowNow();
+		}
+
+		uint64 GetSimTick()
+		{
+			return ADispatch()->GetSimTick();
 		}
 	};
 	
 	//DUMMY FOR NOW.
 	//TODO: IMPLEMENT THE GUNMAP FROM INSTANCE UNTO CLASS
 	//TODO: REMEMBER TO SAY AMMO A BUNCH
-	void RequestAddTicklite(TSharedPtr<TicklitePrototype> ToAdd, TicklitePhase Group)
+	//pass an owner for anything that shouldn't outlive the key it works on.
+	void RequestAddTicklite(TSharedPtr<TicklitePrototype> ToAdd, TicklitePhase Group, FSkeletonKey Owner = FSkeletonKey())
+	{
+		ArtilleryTicklitesWorker_LockstepToWorldSim.RequestAddTicklite(ToAdd, Group, Owner);
+	}
+	//Game thread. retires every ticklite added with this owner, in one go.
+	void RetireTicklitesOwnedBy(FSkeletonKey Owner)
 	{
-		ArtilleryTicklitesWorker_LockstepToWorldSim.RequestAddTicklite(ToAdd, Group);
+		ArtilleryTicklitesWorker_LockstepToWorldSim.RequestRetireOwner(Owner);
 	}
 	FGunKey GetGun(FString GunDefinitionID, FireControlKey MachineKey);
 	FGunKey RegisterExistingGun(FArtilleryGun* toBind, ActorKey ProbableOwner) const;
+	//game thread. builds the set the first time a definition asks for it.
+	const FArtilleryAbilitySet& GetSharedAbilities(uint32 GunDefinitionIndex);
+	//game thread. points a prefire and fire phase's binders at OnGunPhaseEnded. once per ability, never per shot.
+	void BindGunPhases(UArtilleryPerActorAbilityMinimum* Prefire, UArtilleryPerActorAbilityMinimum* Fire);
+	//game thread. a bound phase ended. finds the gun the activation was for and passes the end on to it.
+	void OnGunPhaseEnded(FGunKey Gun, FArtilleryStates OutcomeStates, int DallyFramesToOmit, const FGameplayAbilityActorInfo* ActorInfo, const FGameplayAbilityActivationInfo ActivationInfo, bool PrefireEnded);
+	//game thread. the starting attributes every gun of a definition is prepared and rebound with, built once.
+	TSharedPtr<const TMap<AttribKey, double>> GetAttributeTemplate(uint32 GunDefinitionIndex, int MaxAmmo, int Firerate, int ReloadTime);
 	bool ReleaseGun(FGunKey Key, FireControlKey MachineKey);
 	
 	//TODO: convert to object key to allow the grand dance of the mesh primitives.
+	//either thread. the busy worker is the only thing that asks from off the game thread, and it gets its own mapping.
 	AttrPtr GetAttrib(FSkeletonKey Owner, E_AttribKey Attrib);
 	IdentPtr GetIdent(FSkeletonKey Owner, Ident Attrib);
 	
@@ -267,6 +445,10 @@ public:
 	{
 		GunToFiringFunctionMapping->Add(Key, Machine);
 	}
+	void RegisterCues(FGunKey Key, FArtilleryCueGunFromDispatch Machine)
+	{
+		GunToCueFunctionMapping->Add(Key, Machine);
+	}
 	void RegisterLocomotion(ActorKey Key, FArtilleryRunLocomotionFromDispatch Machine)
 	{
 		ActorToLocomotionMapping->Add(Key, Machine);
@@ -278,31 +460,49 @@ public:
 		{
 			GunToFiringFunctionMapping->Remove(Key);
 		}
+		auto holdopencues = GunToCueFunctionMapping;
+		if(holdopencues && holdopencues.IsValid())
+		{
+			GunToCueFunctionMapping->Remove(Key);
+		}
 		//TODO: add the rest of the wipe here?
 	}
 	void RegisterAttributes(FSkeletonKey in, AttrMapPtr Attributes)
 	{
 		AttributeSetToDataMapping->Add(in, Attributes);
+		AttributeSetChanges.Enqueue({in, Attributes});
+		PublishedSimState->Track(in, Attributes);
 	}
 	void RegisterRelationships(FSkeletonKey in, IdMapPtr Relationships)
 	{
 		IdentSetToDataMapping->Add(in, Relationships);
+		PublishedSimState->Track(in, Relationships);
 	}
 	void DeregisterAttributes(FSkeletonKey in)
 	{
 		AttributeSetToDataMapping->Remove(in);
+		AttributeSetChanges.Enqueue({in, nullptr});
+		PublishedSimState->UntrackAttributes(in);
+		//anything still ticking on these attributes would just be reading a dead key.
+		RetireTicklitesOwnedBy(in);
 	}
 	void DeregisterRelationships(FSkeletonKey in)
 	{
 		IdentSetToDataMapping->Remove(in);
+		PublishedSimState->UntrackIdentities(in);
 	}
 
 	std::atomic_bool UseNetworkInput;
-	bool missedPrior = false;
-	bool burstDropDetected = false;
 
 private:
-	static inline long long monotonkey = 0;
+	//see ReportInputDivergence. MAX_uint64 when nothing's waiting.
+	std::atomic<uint64> EarliestInputDivergence = MAX_uint64;
+	std::atomic<uint32> InputDivergences = 0;
+	//per match, so a match's gun keys don't depend on what else the process is hosting.
+	long long monotonkey = 0;
+	//weak, so gc can take the agent with its actor. the estimator asks from the busy worker's lane, hence the lock.
+	TWeakObjectPtr<UBarragePlayerAgent> LocalPlayerAgent;
+	mutable FCriticalSection LocalPlayerAgentLock;
 	//If you're trying to figure out how artillery works, read the busy worker knowing it's a single thread coming off of Dispatch.
 	//this handles input from bristlecone, patching it into streams from the CanonicalInputStreamECS (ACIS), using the ACIS to perform mappings,
 	//and processing those streams using the pattern matcher. right now, we also expect it to own rollback and jolt when that's implemented.
@@ -311,16 +511,13 @@ private:
 	// This is quite a lot and for performance or legibility reasons there is a good chance that this thread will
 	//need to be split up. On the other hand, we want each loop iteration to run for around 2-4 milliseconds.
 	//this is quite a bit.
+	//it's hosted by the process-wide FArtilleryWorkerPool, whose lanes take turns pumping every match it carries.
 	FArtilleryBusyWorker ArtilleryAsyncWorldSim;
-	//This runs the tickables alongside the worldsim, ticking each time the worldsim ticks
-	//but NOT using locks. So the processing is totally independent. This is extremely fast,
-	//extremely powerful, and the reason why we don't use ticklites when we don't need to.
+	//This runs the tickables in step with the worldsim, ticking each time the worldsim ticks
+	//but NOT using locks. the busy worker calls its calculate and apply halves itself, in the same pump.
+	//This is extremely fast, extremely powerful, and the reason why we don't use ticklites when we don't need to.
 	//it's dangerous as __________ _____________________ _ _________.
 	
 	TickliteWorker ArtilleryTicklitesWorker_LockstepToWorldSim;
-	TUniquePtr<FRunnableThread> WorldSim_Thread;
-	TUniquePtr<FRunnableThread> WorldSim_Ticklites_Thread;
-	FSharedEventRef StartTicklitesSim;
-	FSharedEventRef StartTicklitesApply;
 };
 
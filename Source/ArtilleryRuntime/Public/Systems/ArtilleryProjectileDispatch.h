@@ -8,6 +8,7 @@
 #include "ArtilleryCommonTypes.h"
 #include "ArtilleryDispatch.h"
 #include "FProjectileDefinitionRow.h"
+#include "Engine/StreamableManager.h"
 #include "ArtilleryProjectileDispatch.generated.h"
 
 /**
@@ -29,13 +30,61 @@ namespace Arty
 	DECLARE_MULTICAST_DELEGATE(OnArtilleryProjectilesActivated);
 }
 
+//Everything the fire path needs to know about a projectile definition, resolved at begin play.
+//Archetypes are addressed by a dense index that's stable for the life of the world.
+struct FProjectileArchetype
+{
+	FName ProjectileDefinitionId;
+	FSoftObjectPath MeshPath;
+	//weak, since nothing here is visible to the gc. the manager's ISM is what keeps it alive once bound.
+	TWeakObjectPtr<UStaticMesh> Mesh;
+	TWeakObjectPtr<AInstancedMeshManager> MeshManager;
+	double ImpactDamage = 100;
+};
+
+//One projectile touching one thing. Produced on the busy worker as barrage broadcasts contacts after each step,
+//consumed in bulk by the contact resolver ticklite during final tick resolve.
+struct FProjectileContact
+{
+	FSkeletonKey Projectile;
+	FSkeletonKey EntityHit;
+	double Damage = 0;
+	//the sim tick that picks the contact up, in ticks, not shadow time. see FArtilleryBusyWorker::GetSimTick.
+	uint64 Stamp = 0;
+};
+typedef TCircularQueue<FProjectileContact> ProjectileContactQueue;
+
+//a projectile coming into or going out of the busy worker's view. Damage is negative on the way out.
+struct FProjectileLifeChange
+{
+	FSkeletonKey Projectile;
+	double Damage = 0;
+};
+
+//what the busy worker needs to spawn an archetype by itself. handed over once the archetype's manager exists.
+struct FSimProjectileArchetype
+{
+	//raw, same as MyDispatch. the manager lives as long as the world.
+	AInstancedMeshManager* MeshManager = nullptr;
+	double ImpactDamage = 0;
+};
+
+//a projectile the busy worker spawned, on its way to the game thread for its mesh. no key means the sim couldn't make
+//it, and the game thread spawns the whole thing instead.
+struct FSimSpawnedProjectile
+{
+	FSkeletonKey Projectile;
+	int32 ArchetypeIndex = INDEX_NONE;
+	FTransform WorldTransform;
+	FVector3d MuzzleVelocity = FVector3d::ZeroVector;
+	bool IsSensor = false;
+};
+
 UCLASS()
 class ARTILLERYRUNTIME_API UArtilleryProjectileDispatch : public UWorldSubsystem
 {
 	GENERATED_BODY()
 
-protected:
-	static inline UArtilleryProjectileDispatch* SelfPtr = nullptr;
 public:
 	OnArtilleryProjectilesActivated BindToArtilleryProjectilesActivated;
 
@@ -44,20 +93,63 @@ protected:
 	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
 	virtual void Deinitialize() override;
 
+	UPROPERTY()
 	UDataTable* ProjectileDefinitions;
 	TSharedPtr<TMap<FSkeletonKey, TWeakObjectPtr<AInstancedMeshManager>>> ManagerKeyToMeshManagerMapping;
 	TSharedPtr<TMap<FSkeletonKey, TWeakObjectPtr<AInstancedMeshManager>>> ProjectileKeyToMeshManagerMapping;
-	TSharedPtr<TMap<FName, TWeakObjectPtr<AInstancedMeshManager>>> ProjectileNameToMeshManagerMapping;
+	//single producer (contact broadcast), single consumer (the contact resolver ticklite). both on the busy worker.
+	TSharedPtr<ProjectileContactQueue> ContactsToResolve;
+	//the busy worker's own copy of which projectiles are live and what they hit for, so contacts never touch the maps
+	//the game thread owns. fed by LifeChanges, and a projectile leaves it on its first contact.
+	TMap<FSkeletonKey, double> SimProjectileDamage;
+	//anyone who spawns or deletes, in, busy worker out.
+	TQueue<FProjectileLifeChange, EQueueMode::Mpsc> LifeChanges;
+	//busy worker in, game thread out. projectiles whose contact has been taken, waiting on their ism side going.
+	TQueue<FSkeletonKey, EQueueMode::Spsc> ContactedProjectiles;
+	//busy worker only, by archetype index. fed by SimArchetypeChanges as archetypes are bound.
+	TArray<FSimProjectileArchetype> SimArchetypes;
+	TQueue<TPair<int32, FSimProjectileArchetype>, EQueueMode::Spsc> SimArchetypeChanges;
+	//busy worker in, game thread out. see CreateProjectileInstanceFromSim.
+	TQueue<FSimSpawnedProjectile, EQueueMode::Spsc> SimSpawned;
+
+	//FName is only ever resolved here, once. past this point it's all indices.
+	TMap<FName, int32> ArchetypeIndexByName;
+	TArray<FProjectileArchetype> Archetypes;
+	TMap<FSkeletonKey, int32> ArchetypeIndexByManagerKey;
+	//not a uproperty, world subsystems outlive each other's use of them.
+	UArtilleryDispatch* MyDispatch = nullptr;
+	FStreamableManager StreamableManager;
+	TSharedPtr<FStreamableHandle> DefinitionsLoadHandle;
+	TSharedPtr<FStreamableHandle> MeshesLoadHandle;
+
+	void OnProjectileDefinitionsLoaded();
+	void OnProjectileMeshesLoaded();
+	bool BindArchetype(const int32 ArchetypeIndex);
+	bool BindArchetypeNow(const int32 ArchetypeIndex);
+	TWeakObjectPtr<AInstancedMeshManager> GetArchetypeMeshManager(const int32 ArchetypeIndex);
 
 public:
 	virtual void PostInitialize() override;
 
 	FProjectileDefinitionRow* GetProjectileDefinitionRow(const FName ProjectileDefinitionId);
+	int32 GetProjectileArchetypeIndex(const FName ProjectileDefinitionId);
 	FSkeletonKey CreateProjectileInstance(const FName ProjectileDefinitionId, const FTransform& WorldTransform, const FVector3d& MuzzleVelocity, const bool IsSensor);
-	void DeleteProjectile(const FSkeletonKey Target);
+	FSkeletonKey CreateProjectileInstance(const int32 ArchetypeIndex, const FTransform& WorldTransform, const FVector3d& MuzzleVelocity, const bool IsSensor);
+	int32 CreateProjectileInstances(const FName ProjectileDefinitionId, TArrayView<const FTransform> WorldTransforms, TArrayView<const FVector3d> MuzzleVelocities, const bool IsSensor, TArray<FSkeletonKey>& OutKeys);
+	int32 CreateProjectileInstances(const int32 ArchetypeIndex, TArrayView<const FTransform> WorldTransforms, TArrayView<const FVector3d> MuzzleVelocities, const bool IsSensor, TArray<FSkeletonKey>& OutKeys);
+	//busy worker. resolve the archetype index on the game thread first, GetProjectileArchetypeIndex isn't safe here.
+	FSkeletonKey CreateProjectileInstanceFromSim(const int32 ArchetypeIndex, const FTransform& WorldTransform, const FVector3d& MuzzleVelocity, const bool IsSensor);
+	//game thread, each tick, before DeleteContactedProjectiles. gives what the busy worker spawned its meshes.
+	void FinishSimSpawns();
+	bool DeleteProjectile(const FSkeletonKey Target);
 	TWeakObjectPtr<AInstancedMeshManager> GetProjectileMeshManagerByManagerKey(const FSkeletonKey ManagerKey);
 	TWeakObjectPtr<AInstancedMeshManager> GetProjectileMeshManagerByProjectileKey(const FSkeletonKey ProjectileKey);
 
 	void OnBarrageContactAdded(const BarrageContactEvent& ContactEvent);
+	//game thread, each tick. deletes whatever the busy worker's contacts took since the last one.
+	void DeleteContactedProjectiles();
+	//busy worker. catches the sim's view of live projectiles up with spawns and deletes. contacts do it themselves, and
+	//the contact resolver does it every tick so a quiet stretch doesn't pile the queue up.
+	void TakeLifeChanges();
 	
 };
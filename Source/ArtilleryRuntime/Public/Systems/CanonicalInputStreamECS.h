@@ -12,11 +12,15 @@
 #include "Containers/CircularBuffer.h"
 #include "BristleconeCommonTypes.h"
 #include "UBristleconeWorldSubsystem.h"
+#include <atomic>
 #include <optional>
 #include <unordered_map>
 #include <ArtilleryShell.h>
 #include "ArtilleryCommonTypes.h"
 #include "FArtilleryNoGuaranteeReadOnly.h"
+#include "FArtilleryInputView.h"
+#include "FInputPatternState.h"
+#include "FInputColdLog.h"
 #include "FActionPattern.h"
 #include "CanonicalInputStreamECS.generated.h"
 
@@ -86,10 +90,22 @@ public:
 
 	ActorKey ActorByStream(InputStreamKey Stream);
 	InputStreamKey StreamByActor(ActorKey Stream);
-	static inline UCanonicalInputStreamECS* SelfPtr = nullptr;
 	static const uint32_t InputConservationWindow = 8192;
 	static const uint32_t AddressableInputConservationWindow = InputConservationWindow - (2 *
 		TheCone::LongboySendHertz);
+	//the full-width part of the history. everything older than this, out to the conservation window, is run length
+	//encoded in the cold log. see FInputColdLog.
+	static const uint32_t HotInputWindow = 256;
+	static const uint32_t AddressableHotInputWindow = HotInputWindow - (2 * TheCone::LongboySendHertz);
+	static_assert(2 * TheCone::LongboySendHertz < HotInputWindow / 2, "the hot window needs room past the send margin");
+	//a run is at least one input, so this is enough runs for the whole window even if every input breaks one. it's a
+	//ceiling, not what a stream pays. the log only allocates for the runs it's actually holding, see FInputColdLog.
+	//readers stop at the addressable window, which keeps the same two seconds between them and the run being recycled
+	//as the hot ring keeps between them and the write slot.
+	static const int32 ColdInputRuns = InputConservationWindow - AddressableHotInputWindow;
+	//how far behind the newest cold input a run can end and still be kept. that's the conservation window, measured
+	//from the write slot, so the two seconds of margin past what readers can address is kept here too.
+	static const uint32_t ColdInputWindow = InputConservationWindow - AddressableHotInputWindow;
 	friend class FArtilleryBusyWorker;
 	friend class UArtilleryDispatch;
 	InputStreamKey GetStreamForPlayer(PlayerKey);
@@ -189,13 +205,14 @@ public:
 					auto result = currentPattern-> runPattern(InputCycleNumber, Union, Stream);
 					if (result)
 					{
+						//once per match, not once per bind.
+						auto time = Stream->peek(InputCycleNumber)->SentAt;
 						for (FActionPatternParams& Elem : *currentSet)
 						{
 							if (Elem.ToSeek.getFlat() != 0)
 							{
 								if ((Elem.ToSeek.getFlat() & result) == Elem.ToSeek.getFlat())
 								{
-									auto time = Stream->peek(InputCycleNumber)->SentAt;
 									//THIS IS NOT SUPER SAFE. HAHAHAH. YAY.
 									IN_PARAM_REF_TRIPLEBUFFER_LIFECYLEMANAGED.Add(TPair<ArtilleryTime, FGunKey>(
 											time,
@@ -242,9 +259,26 @@ public:
 		friend class UCanonicalInputStreamECS;
 
 	public:
-		TCircularBuffer<FArtilleryShell> CurrentHistory = TCircularBuffer<FArtilleryShell>(InputConservationWindow);
+		//Conserved input streams used to hold all 8192 inputs at full width, and most of that was the busy worker
+		//repeating the last input. now only the rollback-sized front of it is full width. past that, inputs go into
+		//the cold log as runs. get and peek see one history either way, just a little slower on the cold end.
+		TCircularBuffer<FArtilleryShell> CurrentHistory = TCircularBuffer<FArtilleryShell>(HotInputWindow);
+		//one per input in CurrentHistory, same index. written by Add.
+		TCircularBuffer<FInputPatternFacts> PatternFacts = TCircularBuffer<FInputPatternFacts>(HotInputWindow);
+		FInputColdLog ColdHistory = FInputColdLog(ColdInputRuns, ColdInputWindow);
 		InputStreamKey MyKey;
 
+		//edges, holds, and flicks for an input, worked out when it arrived. patterns should prefer this to sweeping
+		//back through peek. hot window only.
+		const FInputPatternFacts* GetPatternFacts(uint64_t input) const
+		{
+			if (!IsHot(input))
+			{
+				return nullptr;
+			}
+			return &PatternFacts[input];
+		}
+
 
 		//Correct usage procedure is to null check then store a copy.
 		//Failure to follow this procedure will lead to eventual misery.
@@ -261,12 +295,23 @@ public:
 					std::nullopt
 				);
 			}
-			else
+			else if (IsHot(input))
 			{
 				CurrentHistory[input].RunAtLeastOnce = true;
 				//this is the only risky op in here from a threading perspective.
 				return std::optional<FArtilleryShell>(CurrentHistory[input]);
 			}
+			else
+			{
+				//the cold log hands back a copy, and never takes the mark. anything that old has long since had its
+				//chance at cosmetics anyway.
+				std::optional<FArtilleryShell> Cold = ColdHistory.Find(input);
+				if (Cold.has_value())
+				{
+					Cold->RunAtLeastOnce = true;
+				}
+				return Cold;
+			}
 		};
 
 		//THE ONLY DIFFERENCE WITH PEEK IS THAT IT DOES NOT SET RUNATLEASTONCE.
@@ -284,11 +329,38 @@ public:
 					std::nullopt
 				);
 			}
-			else
+			else if (IsHot(input))
 			{
 				return std::optional<FArtilleryShell>(CurrentHistory[input]);
 			}
+			else
+			{
+				return ColdHistory.Find(input);
+			}
 		};
+		//the newest Count inputs that peek would hand back, up to and including Newest, without copying them.
+		//clamped to the hot window, so you can get fewer than you asked for. doesn't mark anything as run.
+		FArtilleryInputView View(uint64_t Newest, uint32_t Count) const
+		{
+			FArtilleryInputView Out;
+			const uint64_t Highest = highestInput;
+			if (Count == 0 || Newest >= Highest)
+			{
+				return Out;
+			}
+			const uint64_t Floor = Highest > AddressableHotInputWindow ? Highest - AddressableHotInputWindow : 0;
+			const uint64_t First = FMath::Max<uint64_t>(Floor, Newest + 1 >= Count ? Newest + 1 - Count : 0);
+			const uint32 Capacity = CurrentHistory.Capacity();
+			const uint32 Start = static_cast<uint32>(First % Capacity);
+			const int32 Length = static_cast<int32>(Newest + 1 - First);
+			const FArtilleryShell* Base = &CurrentHistory[0];
+			const int32 BeforeWrap = FMath::Min<int32>(Length, Capacity - Start);
+			Out.FirstInput = First;
+			Out.Older = TConstArrayView<FArtilleryShell>(Base + Start, BeforeWrap);
+			Out.Newer = TConstArrayView<FArtilleryShell>(Base, Length - BeforeWrap);
+			return Out;
+		}
+
 	public:
 		ActorKey GetActorByInputStream()
 		{
@@ -300,17 +372,50 @@ public:
 		{
 			return highestInput-1;
 		}
+
+		//the earliest sim tick a predicted input turned out wrong on since the last call, if any. this is where a
+		//rollback resims from. a right guess never shows up here.
+		std::optional<uint64_t> TakeEarliestDivergence()
+		{
+			const uint64_t Earliest = EarliestDivergence.exchange(MAX_uint64);
+			return Earliest == MAX_uint64 ? std::nullopt : std::optional<uint64_t>(Earliest);
+		}
 	protected:
 		volatile uint64_t highestInput = 0; // volatile is utterly useless for its intended purpose. 
 		UCanonicalInputStreamECS* ECSParent;
 		TSharedPtr<UCanonicalInputStreamECS::FConservedInputPatternMatcher> MyPatternMatcher;
+		//busy worker only, same as Add.
+		FInputPatternState PatternState;
+		std::atomic<uint64_t> EarliestDivergence = MAX_uint64;
+
+		bool IsHot(uint64_t input) const
+		{
+			return input < highestInput && (highestInput - input) <= AddressableHotInputWindow;
+		}
+
+		//the input about to fall out of the hot window goes to the cold log. this runs before highestInput moves,
+		//so there's no moment where a reader finds it in neither.
+		void RetireToCold()
+		{
+			const uint64_t NextHighest = highestInput + 1;
+			if (NextHighest > AddressableHotInputWindow)
+			{
+				const uint64_t Leaving = NextHighest - AddressableHotInputWindow - 1;
+				ColdHistory.Append(Leaving, CurrentHistory[Leaving]);
+			}
+		}
 
 		//Add can only be used by the Artillery Worker Thread through the methods of the UCISArty.
-		void Add(INNNNCOMING shell, long SentAt)
+		//hands back the input it went in as, which is what Resolve wants later for a predicted one.
+		uint64_t Add(INNNNCOMING shell, long SentAt, bool Predicted = false)
 		{
+			const uint64_t Added = highestInput;
 			CurrentHistory[highestInput].MyInputActions = shell;
 			CurrentHistory[highestInput].ReachedArtilleryAt = ECSParent->Now();
 			CurrentHistory[highestInput].SentAt = SentAt;
+			CurrentHistory[highestInput].Predicted = Predicted;
+			PatternFacts[highestInput] = PatternState.Consume(highestInput, shell);
+			RetireToCold();
 			//this is gonna get weird after a couple refactors, but that's why we hide it here.
 
 			// reading, adding one, and storing are all separate ops. a slice here is never dangerous but can be erroneous.
@@ -323,14 +428,41 @@ public:
 			// interleaved but the value will always be either k or k+1. If it's stale in cache, the worst case
 			// is that the newest input won't be legible yet and this can be resolved by repolling.
 			++highestInput;
+			return Added;
 		};
 
+		//the real input for one we played as a guess. a right guess just loses its mark. a wrong one is written over
+		//and its tick reported, earliest wins. pattern facts stay as the guess made them; a resim rebuilds those.
+		//past the hot window the cold log has it as a guess for good, but we still report it.
+		//busy worker only. readers can see the overwrite land mid-peek, same bargain as Add.
+		void Resolve(uint64_t input, INNNNCOMING shell, uint64_t PlayedAt, bool Diverged)
+		{
+			if (IsHot(input))
+			{
+				if (Diverged)
+				{
+					CurrentHistory[input].MyInputActions = shell;
+				}
+				CurrentHistory[input].Predicted = false;
+			}
+			if (Diverged)
+			{
+				uint64_t Earliest = EarliestDivergence.load();
+				while (PlayedAt < Earliest && !EarliestDivergence.compare_exchange_weak(Earliest, PlayedAt))
+				{
+				}
+			}
+		}
+
 		//Overload for local add via feed from cabling. don't use this unless you are CERTAIN.
 		void Add(INNNNCOMING shell)
 		{
 			CurrentHistory[highestInput].MyInputActions = shell;
 			CurrentHistory[highestInput].ReachedArtilleryAt = ECSParent->Now();
 			CurrentHistory[highestInput].SentAt = ECSParent->Now();
+			CurrentHistory[highestInput].Predicted = false;
+			PatternFacts[highestInput] = PatternState.Consume(highestInput, shell);
+			RetireToCold();
 			++highestInput;
 		};
 	};
@@ -363,11 +495,14 @@ public:
 		TSharedPtr<TArray<FArtilleryShell>> Inputs = MakeShareable(new TArray<FArtilleryShell>);
 		if(sptr)
 		{
-			for(int i = 0; i <= 15; ++i)
+			//newest first, 16 of them. this used to peek the newest 16 times.
+			const FArtilleryInputView View = sptr->View(sptr->GetHighestGuaranteedInput(), 16);
+			Inputs->Reserve(16);
+			for(int i = View.Num() - 1; i >= 0; --i)
 			{
-				auto input =  sptr.Get()->peek( sptr->GetHighestGuaranteedInput());
-				Inputs->Add(input.has_value() ? input.value() : FArtilleryShell());
+				Inputs->Add(View[i]);
 			}
+			Inputs->SetNum(16);
 		}
 		return Inputs;
 	}
@@ -1,19 +1,21 @@
 ﻿#pragma once
 #include "CoreMinimal.h"
-#include "HAL/Runnable.h"
 #include "FControllerState.h"
 #include "SocketSubsystem.h"
 #include "CanonicalInputStreamECS.h"
 #include <thread>
+#include <chrono>
 #include "BristleconeCommonTypes.h"
 #include "Containers/TripleBuffer.h"
 #include "LocomotionParams.h"
+#include "FInputJitterBuffer.h"
 #include <Ticklite.h>
 
 #include "BarrageDispatch.h"
 
+class UArtilleryDispatch;
 
-//this is a busy-style thread, which runs preset bodies of work in a specified order. Generally, the goal is that it never
+//this is a busy-style worker, which runs preset bodies of work in a specified order. Generally, the goal is that it never
 //actually sleeps. In fact, it yields rather than sleeps, in general operation.
 // 
 // This is similar to but functionally very different from a work-stealing or task model like what we see in rust.
@@ -22,27 +24,46 @@
 // The artilleryworker needs to be kept fairly busy or it will melt one cpu core yield-cycling. to be honest, worth it.
 // no, seriously. with all the other sacrifices we've made occupying one core with game-sim physics, reconciliation,
 // rollbacks, and pattern matching is a pretty good bargain. we'll want to revisit this for servers, of course.
-class FArtilleryBusyWorker : public FRunnable {
+//
+// revisited: it's not a thread anymore. it's one match's loop body, pumped by whichever lane of the shared worker pool
+// gets to it next, and it runs its match's ticklites itself. see FArtilleryWorkerPool.
+class FArtilleryBusyWorker {
 	public:
+	static constexpr uint32_t SampleHertz = TheCone::CablingSampleHertz;
+	static constexpr uint32_t SendHertzFactor = SampleHertz / TheCone::LongboySendHertz;
+	static constexpr uint32_t Period = 1000000 / SampleHertz; //swap to microseconds. standardizing.
+	//how long a lane rests between passes over its matches.
+	static constexpr auto PollStep = std::chrono::milliseconds(Period / 2000);
+
 	FArtilleryBusyWorker();
-	virtual ~FArtilleryBusyWorker() override;
+	virtual ~FArtilleryBusyWorker();
 	//This isn't super safe, but Busy Worker is used in exactly one place
 	//and the dispatcher that owns this memory MUST manage this lifecycle.
 	TSharedPtr<BufferedMoveEvents>  RequestorQueue_Locomos_TripleBuffer;
 	TSharedPtr<BufferedEvents> RequestorQueue_Abilities_TripleBuffer;
 	ArtilleryTime TickliteNow = 0;
-	FSharedEventRef StartTicklitesSim;
-	FSharedEventRef StartTicklitesApply;
 	
-	virtual bool Init() override;
-	void RunStandardFrameSim(bool& missedPrior,
+	void RunStandardFrameSim(FInputJitterBuffer& RemoteJitter,
 		uint64_t& currentIndexCabling,
-		bool& burstDropDetected,
+		uint64_t SimTick,
 		TheCone::PacketElement& current,
-		bool& RemoteInput) const;
-	virtual uint32 Run() override;
-	virtual void Exit() override;
-	virtual void Stop() override;
+		bool& RemoteInput);
+	//Lane only, once, before the first pump. false if the dispatch didn't wire us up.
+	bool Begin();
+	//Lane only, any lane, one at a time. one pass of what used to be the run loop: a frame if one's due, then the
+	//cadence book-keeping.
+	void Pump();
+	void Stop();
+	bool IsRunning() const
+	{
+		return running;
+	}
+	//Lane only. ticks run so far. from a pump's calculate through its frame sim it's the tick being run, and from then
+	//on it's the next one, which is the tick anything the step turned up gets dealt with on.
+	uint64_t GetSimTick() const
+	{
+		return SimTick;
+	}
 
 	
 
@@ -50,13 +71,35 @@ class FArtilleryBusyWorker : public FRunnable {
 	//though the clarity gain is quite nice, and privileging Cabling makes sense
 	TSharedPtr<ArtilleryControlStream>  CablingControlStream;
 	TSharedPtr<ArtilleryControlStream> BristleconeControlStream;
+	//what fills in for late remote input. set it before the match is hosted; see ArtilleryInputPrediction.
+	FInputPredictor RemotePredictor = &ArtilleryInputPrediction::RepeatLast;
 	TheCone::RecvQueue InputRingBuffer;
 	TheCone::SendQueue InputSwapSlot;
 	UCanonicalInputStreamECS* ContingentInputECSLinkage;
 	UBarrageDispatch* ContingentPhysicsLinkage;
+	//set in Begin. we don't take this in the header for the same reason we don't take the dispatch anywhere else.
+	UArtilleryDispatch* ContingentDispatchLinkage = nullptr;
 	
 	
 private:
 	void Cleanup();
-	bool running;
+	std::atomic<bool> running;
+	//the barrage feed our world granted us in Begin. barrage finds a thread's feed through a thread local, and lanes
+	//take turns with matches, so every pump puts ours back on whatever lane it's running on.
+	std::remove_cv_t<decltype(UBarrageDispatch::MyBARRAGEIndex)> Feed = {};
+	//what used to be Run's locals. they live as long as the match now, since a pump is one pass, not the whole loop.
+	uint64_t currentIndexCabling = 0;
+	uint64_t currentIndexBristlecone = 0;
+	//one per remote stream. there's one remote stream.
+	FInputJitterBuffer RemoteJitter;
+	//what the jitter buffer resolved this frame. swapped with the buffer's own, so neither ever reallocates.
+	TArray<FInputJitterBuffer::FResolution> Resolutions;
+	uint64_t SimTick = 0;
+	bool sent = false;
+	//TODO: remember why this needs to be an int. Overflow would take a match running for 1000 hours.
+	//if you wanna use this for a really long lived session, you'll need to fix it.
+	int seqNumber = 0;
+	//Hi! Jake here! Reminding you that this will CYCLE
+	uint32_t LastIncrementWindow = 0;
+	uint32_t lsbTime = 0;
 };
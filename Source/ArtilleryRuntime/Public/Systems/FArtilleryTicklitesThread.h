@@ -1,10 +1,14 @@
 ﻿#pragma once
 #include "CoreMinimal.h"
-#include "HAL/Runnable.h"
+#include "Templates/UnrealTemplate.h"
+#include "Containers/Queue.h"
 #include <Ticklite.h>
+#include <atomic>
+#include "FArtillerySpatialGrid.h"
 
-//this is a busy-style thread, which runs preset bodies of work in a specified order. Generally, the goal is that it never
-//actually sleeps. In fact, it only ever waits on the Artillery busy thread.
+//this runs preset bodies of work in a specified order, in two halves, calculate and apply. it used to be a thread of its
+//own that waited on the busy worker between the halves. now the busy worker calls each half itself, on whichever pool
+//lane carries its match, so a match costs one lane instead of two cores. see FArtilleryWorkerPool.
 // 
 // This is similar to but functionally very different from a work-stealing or task model like what we see in rust.
 // This thread runs ticklites, which are simple functions that satisfy the following properties:
@@ -48,8 +52,18 @@
 // Any additional ordering benefits they provide should be considered UB for the time being, and should not be relied on.
 // 
 //  Good luck, and may the force be with you.
+//one sphere cast, as asked for during calculate. see RequestSphereCast.
+struct FShapeCastQuery
+{
+	FBarrageKey Source;
+	float Radius;
+	float Distance;
+	FVector3d Start;
+	FVector3d Direction;
+};
+
 template <typename UDispatch>
-class FArtilleryTicklitesWorker : public FRunnable {
+class FArtilleryTicklitesWorker {
 
 	//This isn't super safe but like busy worker, ticklites only runs in one spot.
 	friend class UArtilleryDispatch;
@@ -63,6 +77,206 @@ class FArtilleryTicklitesWorker : public FRunnable {
 	
 	protected:
 	TickliteBuffer QueuedAdds;
+	//the busy worker's own adds, say from a gun it fired. only it touches this, so no queue.
+	TArray<StampLiteRequest> SimQueuedAdds;
+
+	//owner -> the ticklites it owns. lets an owner's death retire its ticklites without walking every group.
+	//raw pointers are fine, the groups own the ticklites and we always drop the entry before the group does.
+	TMap<FSkeletonKey, TArray<TicklitePrototype*, TInlineAllocator<4>>> TicklitesByOwner;
+	//the game thread's, in practice, but unbounded and mpsc so a burst of deaths, or a second producer, can't drop one.
+	//a dropped retirement is a ticklite that runs forever. the serial is when the retirement was asked for.
+	TQueue<TPair<FSkeletonKey, uint64>, EQueueMode::Mpsc> OwnerRetirements;
+	//orders adds against retirements. a key that dies and comes back between two calculates has its new ticklites queued
+	//after the retirement, and those have to live.
+	std::atomic<uint64> RequestSerials = 0;
+
+	void IndexOwner(TicklitePrototype* Added)
+	{
+		if (Added->Owner != FSkeletonKey())
+		{
+			TicklitesByOwner.FindOrAdd(Added->Owner).Add(Added);
+		}
+	}
+
+	void ForgetOwner(TicklitePrototype* Leaving)
+	{
+		if (Leaving->Retired || Leaving->Owner == FSkeletonKey())
+		{
+			return; // retirement already dropped the whole entry.
+		}
+		if (auto* Owned = TicklitesByOwner.Find(Leaving->Owner))
+		{
+			Owned->RemoveSingleSwap(Leaving, EAllowShrinking::No);
+			if (Owned->IsEmpty())
+			{
+				TicklitesByOwner.Remove(Leaving->Owner);
+			}
+		}
+	}
+
+	//O(k) in the owner's ticklites. they're flagged here and swept out of their groups in the apply pass. only what was
+	//asked for before the retirement goes.
+	void ProcessRetirements()
+	{
+		TPair<FSkeletonKey, uint64> Retirement;
+		while (OwnerRetirements.Dequeue(Retirement))
+		{
+			auto* Owned = TicklitesByOwner.Find(Retirement.Key);
+			if (!Owned)
+			{
+				continue;
+			}
+			for (int32 Index = 0; Index < Owned->Num();)
+			{
+				TicklitePrototype* Retiring = (*Owned)[Index];
+				if (Retiring->RequestSerial < Retirement.Value)
+				{
+					Retiring->Retired = true;
+					Owned->RemoveAtSwap(Index, EAllowShrinking::No);
+				}
+				else
+				{
+					++Index;
+				}
+			}
+			if (Owned->IsEmpty())
+			{
+				TicklitesByOwner.Remove(Retirement.Key);
+			}
+		}
+	}
+
+	//Forces from every ticklite that pushes on a body this tick, summed per body and handed to barrage once per body at the
+	//end of apply, so they land before the next step. the FBLet is kept across ticks; bodies nobody has pushed on in a
+	//couple seconds get dropped, so the cache doesn't hold dead shapes open forever.
+	struct FAccumulatedForce
+	{
+		FBLet Body;
+		VelocityVec Force = VelocityVec::ZeroVector;
+		uint64 LastPushed = 0;
+		bool Pushed = false;
+	};
+	static constexpr uint64 ForceCacheExpiryTicks = 240;
+
+	//Casts asked for this tick, and where their hits land. results are pooled and only ever grow. a result nobody else
+	//is holding gets wiped and reused, and one a callback kept is left to it and replaced, so a kept hit stays its own.
+	//the whole batch goes out at once, after calculate, see RunShapeCasts.
+	TArray<FShapeCastQuery> ShapeCasts;
+	TArray<TSharedPtr<FHitResult>> ShapeCastResults;
+
+	//Who's in the spatial grid. the game thread asks through the queue, we own the list. a key without a shadow transform
+	//is left out of that tick's grid, and if it stays gone for a couple hundred rebuilds it's dropped for good.
+	//the grid itself is only rebuilt on the first GetSpatialGrid of a tick, so a tick nobody queries costs nothing.
+	static constexpr uint16 SpatialExpiryTicks = 240;
+	//unbounded for the same reason as OwnerRetirements. a dropped registration is a key that never shows up in the grid.
+	TQueue<FSkeletonKey, EQueueMode::Mpsc> SpatialRegistrations;
+	TMap<FSkeletonKey, uint16> SpatialMembers; // key -> rebuilds in a row it's been missing.
+	TArray<FSkeletonKey> SpatialKeys;
+	TArray<FVector3d> SpatialLocations;
+	TBitArray<> SpatialFound;
+	TArray<FSkeletonKey> GridKeys;
+	TArray<FVector3d> GridLocations;
+	FArtillerySpatialGrid SpatialGrid;
+	bool SpatialGridStale = true;
+
+	//every tick, so the queue never backs up, even while nobody's asking for the grid.
+	void DrainSpatialRegistrations()
+	{
+		FSkeletonKey Added;
+		while (SpatialRegistrations.Dequeue(Added))
+		{
+			if (!SpatialMembers.Contains(Added))
+			{
+				SpatialMembers.Add(Added, 0);
+				SpatialKeys.Add(Added);
+			}
+		}
+	}
+
+	void RebuildSpatialGrid()
+	{
+		SpatialLocations.Reset();
+		DispatchOwner->GatherShadowLocations(SpatialKeys, SpatialLocations, SpatialFound);
+		if (SpatialLocations.Num() != SpatialKeys.Num())
+		{
+			return; // no transforms to be had this tick. last tick's grid stands.
+		}
+		GridKeys.Reset();
+		GridLocations.Reset();
+		for (int32 i = 0; i < SpatialKeys.Num();)
+		{
+			uint16& Misses = SpatialMembers.FindChecked(SpatialKeys[i]);
+			if (SpatialFound[i])
+			{
+				Misses = 0;
+				GridKeys.Add(SpatialKeys[i]);
+				GridLocations.Add(SpatialLocations[i]);
+			}
+			else if (++Misses > SpatialExpiryTicks)
+			{
+				SpatialMembers.Remove(SpatialKeys[i]);
+				//swap the tail in and look at this slot again.
+				SpatialKeys.RemoveAtSwap(i, 1, EAllowShrinking::No);
+				SpatialLocations.RemoveAtSwap(i, 1, EAllowShrinking::No);
+				SpatialFound.RemoveAtSwap(i);
+				continue;
+			}
+			++i;
+		}
+		SpatialGrid.Rebuild(GridKeys, GridLocations);
+	}
+
+	void RunShapeCasts()
+	{
+		if (ShapeCasts.IsEmpty())
+		{
+			return;
+		}
+		ShapeCastResults.SetNum(FMath::Max(ShapeCastResults.Num(), ShapeCasts.Num()), EAllowShrinking::No);
+		for (int32 Index = 0; Index < ShapeCasts.Num(); ++Index)
+		{
+			TSharedPtr<FHitResult>& Result = ShapeCastResults[Index];
+			if (Result.IsValid() && Result.GetSharedReferenceCount() == 1)
+			{
+				*Result = FHitResult();
+			}
+			else
+			{
+				Result = MakeShared<FHitResult>();
+			}
+		}
+		DispatchOwner->RunShapeCasts(ShapeCasts, ShapeCastResults);
+	}
+	TMap<FSkeletonKey, FAccumulatedForce> AccumulatedForces;
+	uint64 ApplyTicks = 0;
+
+	void FlushForces()
+	{
+		for (auto It = AccumulatedForces.CreateIterator(); It; ++It)
+		{
+			FAccumulatedForce& Accumulated = It.Value();
+			if (!Accumulated.Pushed)
+			{
+				if (ApplyTicks - Accumulated.LastPushed > ForceCacheExpiryTicks)
+				{
+					It.RemoveCurrent();
+				}
+				continue;
+			}
+			if (!Accumulated.Body)
+			{
+				Accumulated.Body = DispatchOwner->GetFBLetByObjectKey(It.Key(), LocalNow);
+			}
+			if (Accumulated.Body)
+			{
+				FBarragePrimitive::ApplyForce(Accumulated.Force, Accumulated.Body);
+			}
+			Accumulated.Force = VelocityVec::ZeroVector;
+			Accumulated.Pushed = false;
+			Accumulated.LastPushed = ApplyTicks;
+		}
+		++ApplyTicks;
+	}
 	
 	TSharedPtr<TicklitePrototype> TickliteAdd(TSharedPtr<TicklitePrototype> AllocatedTL,  TicklitePhase Group)
 	{
@@ -91,11 +305,9 @@ class FArtilleryTicklitesWorker : public FRunnable {
 		}
 		return nullptr;
 	}
-	//we may be able to remove sim or move it outside the run loop. I don't think there's anything wrong with simulating
-	//as fast as we can, and it buys us a lot of perf time by not sleeping the thread until it's apply time.
-	FSharedEventRef StartTicklitesSim;
-	//Apply is necessary.
-	FSharedEventRef StartTicklitesApply;
+	//this match's regen clock. see FConservedAttributeData::SetRegen. shared so an attribute that outlives the match
+	//doesn't read a dead clock.
+	TSharedPtr<std::atomic<uint64>> RegenClock = MakeShared<std::atomic<uint64>>(0);
 	public:
 	//Templating here is used to both make reparenting easier if needed later and to simplify our dependency tree
 	UDispatch* DispatchOwner;
@@ -108,28 +320,93 @@ class FArtilleryTicklitesWorker : public FRunnable {
 	{
 		return DispatchOwner->GetFBLetByObjectKey(Target,  Now);
 	}
-	FArtilleryTicklitesWorker(): LocalNow(0), DispatchOwner(nullptr), running(false)
+	FArtilleryTicklitesWorker(): LocalNow(0), DispatchOwner(nullptr)
 	{
-		QueuedAdds = MakeShareable(new TickliteRequests(128));
+		//sized for bulk projectile spawns. a circular queue drops on full, and a couple of shotguns in one tick will blow past 128.
+		QueuedAdds = MakeShareable(new TickliteRequests(1024));
 	}
 
-	void RequestAddTicklite(TSharedPtr<TicklitePrototype> ToAdd, TicklitePhase Group)
+	//either thread. the game thread's adds come through the queue, the busy worker's go straight on SimQueuedAdds. both
+	//come in at the next calculate.
+	void RequestAddTicklite(TSharedPtr<TicklitePrototype> ToAdd, TicklitePhase Group, FSkeletonKey Owner = FSkeletonKey())
 	{
-		QueuedAdds->Enqueue(StampLiteRequest(ToAdd, Group));
+		ToAdd->Owner = Owner;
+		ToAdd->RequestSerial = RequestSerials.fetch_add(1, std::memory_order_relaxed);
+		if (IsInGameThread())
+		{
+			if (!QueuedAdds->Enqueue(StampLiteRequest(ToAdd, Group)))
+			{
+				UE_LOG(LogTemp, Error, TEXT("Ticklites: add queue is full, a ticklite was dropped. Raise its size."));
+			}
+		}
+		else
+		{
+			SimQueuedAdds.Add(StampLiteRequest(ToAdd, Group));
+		}
+	}
+
+	//Game thread. every ticklite this key owned when it asked stops before the next apply. ones added for the key after
+	//this, say by a recycled key's next life, are left alone.
+	void RequestRetireOwner(FSkeletonKey Owner)
+	{
+		OwnerRetirements.Enqueue(TPair<FSkeletonKey, uint64>(Owner, RequestSerials.fetch_add(1, std::memory_order_relaxed)));
 	}
 	
+	//Game thread. the key shows up in the grid from the next tick on.
+	void RequestSpatialRegistration(FSkeletonKey Key)
+	{
+		SpatialRegistrations.Enqueue(Key);
+	}
+
+	//Ticklites only, calculate or apply. built on the first call in a tick, then frozen for the rest of it, so no locks
+	//and every ticklite agrees on where things were.
+	const FArtillerySpatialGrid& GetSpatialGrid()
+	{
+		if (SpatialGridStale)
+		{
+			SpatialGridStale = false;
+			RebuildSpatialGrid();
+		}
+		return SpatialGrid;
+	}
+
+	//Calculate phase only. returns the index to read the hit back with in apply, via GetShapeCastResult.
+	int32 RequestSphereCast(const FShapeCastQuery& Query)
+	{
+		return ShapeCasts.Add(Query);
+	}
+
+	//Apply phase only. nothing here writes to the result while you hold it. once you let go, it's reused.
+	TSharedPtr<FHitResult> GetShapeCastResult(int32 Index) const
+	{
+		return ShapeCastResults.IsValidIndex(Index) && Index < ShapeCasts.Num() ? ShapeCastResults[Index] : nullptr;
+	}
+
+	//Apply phase only. see FlushForces.
+	void AccumulateForce(FSkeletonKey Target, VelocityVec Force)
+	{
+		FAccumulatedForce& Accumulated = AccumulatedForces.FindOrAdd(Target);
+		Accumulated.Force += Force;
+		Accumulated.Pushed = true;
+	}
+
 	inline ArtilleryTime GetShadowNow()
 	const
 	{
 		return DispatchOwner->GetShadowNow();
 	}
 
+	inline uint64 GetSimTick() const
+	{
+		return DispatchOwner->GetSimTick();
+	}
+
 	inline AttrPtr GetAttrib(FSkeletonKey Target, AttribKey Attr)
 	{
 		return DispatchOwner->GetAttrib(Target, Attr);
 	}
 
-	virtual ~FArtilleryTicklitesWorker() override
+	virtual ~FArtilleryTicklitesWorker()
 	{
 		UE_LOG(LogTemp, Display, TEXT("Artillery: Destructing SimTicklites thread."));
 	};
@@ -143,13 +420,10 @@ class FArtilleryTicklitesWorker : public FRunnable {
 		throw; 
 	}
 
-	virtual bool Init() override
+	//Ticklites only. attributes regenerating in this match read their line off this.
+	const TSharedPtr<std::atomic<uint64>>& GetRegenClock() const
 	{
-		LocalNow = 0;
-		UE_LOG(LogTemp, Display, TEXT("Artillery: Booting SimTicklites thread."));
-		running = true;
-		return true;
-		
+		return RegenClock;
 	}
 	//TODO: ADD NULL GUARDS OR COPY. PREFER GUARD.
 	void ApplyINE(TSharedPtr<TicklitePrototype>& x)
@@ -169,7 +443,7 @@ class FArtilleryTicklitesWorker : public FRunnable {
 	//TODO: ADD NULL GUARDS OR COPY. PREFER GUARD.
 	void CalcINE(TSharedPtr<TicklitePrototype>& x)
 	{
-		if( x->ShouldExpireTickable())
+		if(x->Retired || x->ShouldExpireTickable())
 		{
 			//TODO: swap from arrays to slab or true pool?
 			//Can't implement until we're sure that they _tick_
@@ -181,89 +455,93 @@ class FArtilleryTicklitesWorker : public FRunnable {
 	}
 
 	//adding cadence is going to be quite annoying.
-	virtual uint32 Run() override
+	//Busy worker, each tick, before the frame sim. this is the half that used to run while the busy worker worked.
+	//ticklite impls reach us through TL_ThreadedImpl::ADispatch(), which is per thread. each half points it at us for
+	//as long as it runs, so it's null on that thread outside a tick, same as everywhere else.
+	void Calculate()
 	{
-		StartTicklitesSim->Wait();
-		DispatchOwner->ThreadSetup();
-		while(running) {
-
-			for(auto& Group : ExecutionGroups)
+		typename UDispatch::TL_ThreadedImpl::FBindScope Bind(this);
+		ShapeCasts.Reset();
+		DrainSpatialRegistrations();
+		SpatialGridStale = true;
+		for(auto& Group : ExecutionGroups)
+		{
+			for(auto Tickable : Group)
 			{
-				for(auto Tickable : Group)
-				{
-					CalcINE(Tickable);
-				}
+				CalcINE(Tickable);
 			}
-			//if we have any ticklite requests, perform their calculations here and then
-			//add them.
-			//TODO: Reassess 12/10/24
-			//this may cause consistency issues during resim, as artillery guns are fired on the main thread
-			//which is not cadence-locked to the artillery threads. however, during resim, I believe this can be
-			//resolved with the ticklite's add timestamp. and until we have resim, this is a non-issue.
-			while(!QueuedAdds->IsEmpty())
+		}
+		//if we have any ticklite requests, perform their calculations here and then
+		//add them.
+		//TODO: Reassess 12/10/24
+		//this may cause consistency issues during resim, as artillery guns are fired on the main thread
+		//which is not cadence-locked to the artillery threads. however, during resim, I believe this can be
+		//resolved with the ticklite's add timestamp. and until we have resim, this is a non-issue.
+		while(!QueuedAdds->IsEmpty())
+		{
+			const StampLiteRequest AddTup = *QueuedAdds->Peek();
+			auto ptr =  TickliteAdd(AddTup.Key, AddTup.Value);
+			if(ptr)
 			{
-				const StampLiteRequest AddTup = *QueuedAdds->Peek();
-				auto ptr =  TickliteAdd(AddTup.Key, AddTup.Value);
-				if(ptr)
-				{
-					CalcINE(ptr);
-				}
-				QueuedAdds->Dequeue();
+				IndexOwner(ptr.Get());
+				CalcINE(ptr);
 			}
-			
-			StartTicklitesApply->Wait();
-			StartTicklitesApply->Reset(); // we can run long on sim, not on apply.
-
+			QueuedAdds->Dequeue();
+		}
+		//by index, since a ticklite's calculate can add more.
+		for (int32 Index = 0; Index < SimQueuedAdds.Num(); ++Index)
+		{
+			const StampLiteRequest AddTup = SimQueuedAdds[Index];
+			auto ptr = TickliteAdd(AddTup.Key, AddTup.Value);
+			if(ptr)
+			{
+				IndexOwner(ptr.Get());
+				CalcINE(ptr);
+			}
+		}
+		SimQueuedAdds.Reset();
+		//after the adds, so a ticklite added and retired in the same tick still goes. the serials keep it from taking
+		//anything added after the retirement was asked for.
+		ProcessRetirements();
+		RunShapeCasts();
+	}
 
-			for (auto& Group : ExecutionGroups)
+	//Busy worker, each tick, after the physics is stacked up and before it steps.
+	void Apply()
+	{
+		typename UDispatch::TL_ThreadedImpl::FBindScope Bind(this);
+		for (auto& Group : ExecutionGroups)
+		{
+			//this is just to make it clearer, 0 works just as well.
+			int finalsize =  Group.IsEmpty() ? -1 : Group.Num();
+			for(int index = 0; index < finalsize;)
 			{
-				//this is just to make it clearer, 0 works just as well.
-				int finalsize =  Group.IsEmpty() ? -1 : Group.Num();
-				for(int index = 0; index < finalsize;)
+				//either a ticklite expires, and the count remaining drops by one, or we process it and move to next.
+				if(Group[index]->Retired || Group[index]->ShouldExpireTickable())
 				{
-					//either a ticklite expires, and the count remaining drops by one, or we process it and move to next.
-					if(Group[index]->ShouldExpireTickable())
+					//a retired ticklite's owner is already gone. nothing for OnExpiration to talk to.
+					if(!Group[index]->Retired)
 					{
 						Group[index]->OnExpireTickable();
-						//TODO good chance we must save the ticklites from older frames that have expired if we want any hope at determinism
-						//TODO THIS VIOLATES ORDERING. ...kinda. it's complicated. look, you almost certainly don't want it here.
-						//we probably need to use sorted array anyway.
-						Group.RemoveAtSwap(index, EAllowShrinking::No); //Determinism risk 
-						
-						--finalsize;//hohoho. merry nothingmas.
-					}
-					else
-					{
-						Group[index]->ApplyTickable();
-						index++;
 					}
+					ForgetOwner(Group[index].Get());
+					//TODO good chance we must save the ticklites from older frames that have expired if we want any hope at determinism
+					//TODO THIS VIOLATES ORDERING. ...kinda. it's complicated. look, you almost certainly don't want it here.
+					//we probably need to use sorted array anyway.
+					Group.RemoveAtSwap(index, EAllowShrinking::No); //Determinism risk 
+					
+					--finalsize;//hohoho. merry nothingmas.
+				}
+				else
+				{
+					Group[index]->ApplyTickable();
+					index++;
 				}
 			}
 		}
-	
-		return 0;
-	}
-
-	virtual void Exit() override
-	{
-		UE_LOG(LogTemp, Display, TEXT("Artillery: Exiting SimTicklites thread."));
-		running = false;
-		Cleanup();
-	}
-
-	virtual void Stop() override
-	{
-		FRunnable::Stop();
+		FlushForces();
+		DispatchOwner->PublishSimState();
+		//the only thing that moves the clock. once per tick, after apply.
+		RegenClock->fetch_add(1, std::memory_order_relaxed);
 	}
-
-
-
-	
-	
-private:
-	void Cleanup()
-	{
-		running = false;
-	};
-	bool running;
 };
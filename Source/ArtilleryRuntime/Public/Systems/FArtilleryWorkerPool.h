@@ -0,0 +1,88 @@
+#pragma once
+#include "CoreMinimal.h"
+#include "HAL/Runnable.h"
+#include "HAL/RunnableThread.h"
+#include <atomic>
+
+class FArtilleryBusyWorker;
+
+//One process, many matches. every match used to get a busy worker thread and a ticklites thread of its own, which is
+//two cores per match whether it's doing anything or not, so hosting meant one server process per match. now each match
+//is a busy worker that runs its own ticklites, pumped by a lane. a lane is one thread, and there are never more lanes
+//than cores, or than matches.
+//
+//lanes don't belong to matches. each one takes the next match that's due and isn't already being pumped, round robin,
+//pumps it once, and moves on, so any number of matches share however many cores there are. a match is only ever on
+//one lane at a time, and every match carries its own barrage feed from lane to lane, see FArtilleryBusyWorker::Pump.
+//lanes come up as matches are hosted and go down as they're released, so a process between matches isn't spinning
+//anything.
+//
+//Host and Release are game thread only.
+class ARTILLERYRUNTIME_API FArtilleryWorkerPool
+{
+public:
+	static FArtilleryWorkerPool& Get();
+
+	//the match is started on the first pass any lane makes over it.
+	void Host(FArtilleryBusyWorker* Match);
+	//blocks until whatever lane has the match finishes its pass. the match won't be pumped again once this returns.
+	void Release(FArtilleryBusyWorker* Match);
+
+	int32 NumLanes() const
+	{
+		FScopeLock Hold(&PoolLock);
+		return Lanes.Num();
+	}
+
+	~FArtilleryWorkerPool();
+
+private:
+	struct FHosted
+	{
+		explicit FHosted(FArtilleryBusyWorker* InMatch) : Match(InMatch)
+		{
+		}
+
+		FArtilleryBusyWorker* const Match;
+		//set by the lane that claims the match, cleared when its pass is done. release waits on it.
+		std::atomic<bool> InPump = false;
+		//pool lock held. when a lane should next take the match.
+		double NextDue = 0;
+		//only touched by the lane holding InPump.
+		bool bBegun = false;
+		bool bStarted = false;
+	};
+
+	class FLane : public FRunnable
+	{
+	public:
+		explicit FLane(FArtilleryWorkerPool& InPool) : Pool(InPool)
+		{
+		}
+
+		virtual uint32 Run() override;
+
+		virtual void Stop() override
+		{
+			bRunning = false;
+		}
+
+		FArtilleryWorkerPool& Pool;
+		std::atomic<bool> bRunning = true;
+		TUniquePtr<FRunnableThread> Thread;
+	};
+
+	//lane side. the next match that's due and free, or null if there isn't one right now.
+	TSharedPtr<FHosted> Claim();
+	//lane side. a claimed match's pass, begin included the first time.
+	static void PumpClaimed(FHosted& Hosted);
+	//pool lock held. brings lanes up to match the work, never past the cores.
+	void GrowLanes();
+
+	mutable FCriticalSection PoolLock;
+	TArray<TUniquePtr<FLane>> Lanes;
+	TArray<TSharedPtr<FHosted>> Hosted;
+	//where the next claim starts looking, so every match gets its turn.
+	int32 Cursor = 0;
+	int32 LanesStarted = 0;
+};
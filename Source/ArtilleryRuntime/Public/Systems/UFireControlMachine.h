@@ -122,6 +122,9 @@ public:
 		Arty::FArtilleryFireGunFromDispatch Inbound;
 		Inbound.BindUObject(this, &UFireControlMachine::FireGun);
 		MyDispatch->RegisterReady(ToFire, Inbound);
+		Arty::FArtilleryCueGunFromDispatch Cues;
+		Cues.BindUObject(this, &UFireControlMachine::PlayGunCues);
+		MyDispatch->RegisterCues(ToFire, Cues);
 		MyGuns.Add(ToFire);
 	};
 
@@ -142,6 +145,7 @@ public:
 		FActionBitMask IntentBitPattern;
 		IntentBitPattern.buttons = BindIntent;
 		Gun->UpdateProbableOwner(ParentKey);
+		Gun->BindDispatch(MyDispatch);
 		Gun->Initialize(Gun->MyGunKey, false);
 		auto key = MyDispatch->RegisterExistingGun(Gun, ParentKey);
 		pushPatternToRunner(Pattern, APlayer::CABLE, IntentBitPattern, key);
@@ -199,21 +203,33 @@ public:
 	// I'm deferring the solve for how we use them for now, in a desperate effort to
 	// make sure we can preserve as much of the ability framework as possible
 	// but spec management is going to be mission critical for determinism
+	//
+	// the spec was only ever built for its handle, so the gun makes one handle at prewarm and we reuse it. no spec per shot.
 	void FireGun(TSharedPtr<FArtilleryGun> Gun, bool InputAlreadyUsedOnce)
 	{
-		//frig.
-		FGameplayAbilitySpec BackboneFiring = BuildAbilitySpecFromClass(
-			(Gun->Prefire).GetClass(),
-			0,
-			-1
-		);
-		FGameplayAbilitySpecHandle FireHandle = BackboneFiring.Handle;
+		if (!Gun->FireHandle.IsValid())
+		{
+			//guns that skipped prewarm. pays once.
+			Gun->FireHandle = FGameplayAbilitySpecHandle::GenerateNewHandle();
+		}
 		Gun->PreFireGun(
-			FireHandle,
+			Gun->FireHandle,
 			AbilityActorInfo.Get(),
 			FGameplayAbilityActivationInfo(EGameplayAbilityActivationMode::Authority));
 	};
 
+	//guns that resolve on the busy worker land here instead. the shot already happened, this is just the show.
+	void PlayGunCues(TSharedPtr<FArtilleryGun> Gun, bool Fired)
+	{
+		if (Gun.IsValid())
+		{
+			Gun->PlayFireCues(
+				Fired,
+				AbilityActorInfo.Get(),
+				FGameplayAbilityActivationInfo(EGameplayAbilityActivationMode::Authority));
+		}
+	};
+
 	void InitializeComponent() override
 	{
 		Super::InitializeComponent();
@@ -32,34 +32,65 @@
 		}
 
 
-		void RechargeClamp(AttrPtr bindH, AttribKey Max, AttribKey Current)
+		//regen doesn't tick anymore. the current attribute carries its own rate and cap and works out its value when read,
+		//see FConservedAttributeData::GetLiveValue. all we do per tick is notice when the rate or the max moved, and
+		//start a new segment when they do. no history write unless something real happened.
+		struct FRegenBinding
 		{
-			if(bindH != nullptr && bindH->GetCurrentValue() > 0)
+			AttrPtr Rate;
+			AttrPtr Max;
+			AttrPtr Current;
+		};
+		FRegenBinding Health;
+		FRegenBinding Shields;
+		FRegenBinding Mana;
+		bool Bound = false;
+
+		void Bind(FRegenBinding& Binding, AttribKey Rate, AttribKey Max, AttribKey Current)
+		{
+			Binding.Rate = TL_ThreadedImpl::ADispatch()->GetAttrib(EntityKey, Rate);
+			Binding.Max = TL_ThreadedImpl::ADispatch()->GetAttrib(EntityKey, Max);
+			Binding.Current = TL_ThreadedImpl::ADispatch()->GetAttrib(EntityKey, Current);
+		}
+
+		void RechargeClamp(const FRegenBinding& Binding)
+		{
+			if (Binding.Current == nullptr)
+			{
+				return;
+			}
+			//note that current does not check 0. lmao. it used to.
+			const double Rate = Binding.Rate != nullptr ? Binding.Rate->GetCurrentValue() : 0;
+			const double Max = Binding.Max != nullptr ? Binding.Max->GetCurrentValue() : 0;
+			if (Rate > 0 && Max > 0)
 			{
-				auto bindHMax = TL_ThreadedImpl::ADispatch->GetAttrib(EntityKey, Max);
-				auto bindHCur = TL_ThreadedImpl::ADispatch->GetAttrib(EntityKey, Current);
-				if(
-					(bindHMax != nullptr && bindHMax->GetCurrentValue() > 0) &&
-					(bindHCur != nullptr)) //note that current does not check 0. lmao. it used to.
-				{
-					auto clamped = std::min(bindH->GetCurrentValue() + bindHCur->GetCurrentValue(), bindHMax->GetCurrentValue());
-					bindHCur->SetCurrentValue(clamped);
-				}
+				Binding.Current->SetRegen(Rate, Max, TL_ThreadedImpl::ADispatch()->GetRegenClock());
+			}
+			else
+			{
+				Binding.Current->SetRegen(0, 0, TL_ThreadedImpl::ADispatch()->GetRegenClock());
 			}
 		}
 
-		//This can be set up to autowire, but I'm not sure we're keeping these mechanisms yet.
-		//we can speed this up considerably by adding a get all attribs. not sure we wanna though until optimization demands it.
+		static bool IsBound(const FRegenBinding& Binding)
+		{
+			return Binding.Current != nullptr && Binding.Rate != nullptr && Binding.Max != nullptr;
+		}
+
+		//attributes are normally all registered before this ticklite is. if one shows up late, keep looking until it does.
 		void TICKLITE_Apply()
 		{
-			//factor the get attr down to the impl.
-			auto ManaRecharge =  TL_ThreadedImpl::ADispatch->GetAttrib(EntityKey,  Attr::ManaRechargePerTick);
-			auto ShieldRecharge =  TL_ThreadedImpl::ADispatch->GetAttrib(EntityKey, Attr::ShieldsRechargePerTick);
-			auto HealthRecharge =  TL_ThreadedImpl::ADispatch->GetAttrib(EntityKey, Attr::HealthRechargePerTick);
-			
-			RechargeClamp(HealthRecharge, Attr::MaxHealth, Attr::Health);
-			RechargeClamp(ShieldRecharge, Attr::MaxShields, Attr::Shields);
-			RechargeClamp(ManaRecharge, Attr::MaxMana, Attr::Mana);
+			if (!Bound)
+			{
+				Bind(Health, Attr::HealthRechargePerTick, Attr::MaxHealth, Attr::Health);
+				Bind(Shields, Attr::ShieldsRechargePerTick, Attr::MaxShields, Attr::Shields);
+				Bind(Mana, Attr::ManaRechargePerTick, Attr::MaxMana, Attr::Mana);
+				//rate and max can show up late too, and RechargeClamp treats a missing one as no regen.
+				Bound = IsBound(Health) && IsBound(Shields) && IsBound(Mana);
+			}
+			RechargeClamp(Health);
+			RechargeClamp(Shields);
+			RechargeClamp(Mana);
 		}
 		
 		void TICKLITE_CoreReset()
@@ -68,7 +99,7 @@
 
 		bool TICKLITE_CheckForExpiration()
 		{
-			return false; //add check for aliveness of ya owner, factor that down.
+			return false; //we are registered with the entity as owner. DeregisterAttributes retires us.
 		}
 
 		void TICKLITE_OnExpiration()
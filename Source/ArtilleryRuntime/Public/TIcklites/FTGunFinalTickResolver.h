@@ -34,7 +34,7 @@
 		void TICKLITE_Apply()
 		{
 			// handle gun cooldown (fire rate)
-			auto GunCooldownRemaining = TL_ThreadedImpl::ADispatch->GetAttrib(EntityKey,  COOLDOWN_REMAINING);
+			auto GunCooldownRemaining = TL_ThreadedImpl::ADispatch()->GetAttrib(EntityKey,  COOLDOWN_REMAINING);
 
 			// Reduce cd remaining by one tick, flooring at 0.
 			if (GunCooldownRemaining.IsValid())
@@ -46,10 +46,10 @@
 			}
 
 			// handle reload
-			auto CurrentAmmo = TL_ThreadedImpl::ADispatch->GetAttrib(EntityKey,  AMMO);
-			auto MaxAmmo = TL_ThreadedImpl::ADispatch->GetAttrib(EntityKey,  MAX_AMMO);
-			auto ReloadTime = TL_ThreadedImpl::ADispatch->GetAttrib(EntityKey,  RELOAD);
-			auto ReloadRemaining = TL_ThreadedImpl::ADispatch->GetAttrib(EntityKey,  RELOAD_REMAINING);
+			auto CurrentAmmo = TL_ThreadedImpl::ADispatch()->GetAttrib(EntityKey,  AMMO);
+			auto MaxAmmo = TL_ThreadedImpl::ADispatch()->GetAttrib(EntityKey,  MAX_AMMO);
+			auto ReloadTime = TL_ThreadedImpl::ADispatch()->GetAttrib(EntityKey,  RELOAD);
+			auto ReloadRemaining = TL_ThreadedImpl::ADispatch()->GetAttrib(EntityKey,  RELOAD_REMAINING);
 			if (MaxAmmo.IsValid() && CurrentAmmo.IsValid())
 			{
 				auto CurrentAmmoValue = CurrentAmmo->GetCurrentValue();
@@ -87,7 +87,7 @@
 
 		bool TICKLITE_CheckForExpiration()
 		{
-			return false; //add check for aliveness of ya owner, factor that down.
+			return false; //we are registered with the gun key as owner. ReleaseGun retires us.
 		}
 
 		void TICKLITE_OnExpiration()
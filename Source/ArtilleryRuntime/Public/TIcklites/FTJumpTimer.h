@@ -27,7 +27,7 @@ public:
 	}
 	
 	void TICKLITE_Apply() {
-		auto ticksLeftPtr = ADispatch->GetAttrib(JumpTarget, Attr::TicksTilJumpAvailable);
+		auto ticksLeftPtr = ADispatch()->GetAttrib(JumpTarget, Attr::TicksTilJumpAvailable);
 		if (!ticksLeftPtr)
 		{
 			return;
@@ -40,7 +40,7 @@ public:
 	}
 
 	bool TICKLITE_CheckForExpiration() {
-		auto ticksLeftPtr = ADispatch->GetAttrib(JumpTarget, Attr::TicksTilJumpAvailable);
+		auto ticksLeftPtr = ADispatch()->GetAttrib(JumpTarget, Attr::TicksTilJumpAvailable);
 
 		// If there is no valid ptr, expire
 		if (!ticksLeftPtr)
@@ -43,13 +43,9 @@ public:
 	//but for now, this is good enough for testing.
 	void TICKLITE_Apply()
 	{
-		ArtilleryTime Now = this->GetShadowNow();
 		--TicksRemaining;
-		FBLet GameSimPhysicsObject = this->ADispatch->GetFBLetByObjectKey(VelocityTarget, Now);
-		if(GameSimPhysicsObject)
-		{
-			FBarragePrimitive::ApplyForce(PerTickVelocityToApply, GameSimPhysicsObject);
-		}
+		//summed with everything else pushing on this body, and sent to barrage once at the end of apply.
+		this->ADispatch()->AccumulateForce(VelocityTarget, PerTickVelocityToApply);
 	}
 	void TICKLITE_CoreReset()
 	{
@@ -41,7 +41,7 @@ public:
 	}
 	void TICKLITE_Calculate()
 	{
-		UArtilleryLibrary::K2_GetPlayerDirectionEstimator(EstimatedDirection);
+		UArtilleryLibrary::K2_GetPlayerDirectionEstimator(this->ADispatch()->DispatchOwner, EstimatedDirection);
 		EstimatedDirection.Normalize();
 		auto Input = PerTickVelocityToApply.GetSafeNormal2D();
 		Force = ((Input + Input + EstimatedDirection) /3 ).GetSafeNormal() *  PerTickVelocityToApply.Length();
@@ -50,13 +50,9 @@ public:
 	//but for now, this is good enough for testing.
 	void TICKLITE_Apply()
 	{
-		ArtilleryTime Now = this->GetShadowNow();
 		--TicksRemaining;
-		FBLet GameSimPhysicsObject = this->ADispatch->GetFBLetByObjectKey(VelocityTarget, Now);
-		if(GameSimPhysicsObject)
-		{
-			FBarragePrimitive::ApplyForce(Force, GameSimPhysicsObject);
-		}
+		//summed with everything else pushing on this body, and sent to barrage once at the end of apply.
+		this->ADispatch()->AccumulateForce(VelocityTarget, Force);
 	}
 	void TICKLITE_CoreReset()
 	{
@@ -0,0 +1,137 @@
+#pragma once
+#include "Ticklite.h"
+#include "ArtilleryDispatch.h"
+#include "ArtilleryProjectileDispatch.h"
+#include "FArtilleryTicklitesThread.h"
+
+//A ticklite's impl component(s) must provide:
+	//TICKLITE_StateReset on the memory block aspect
+	//TICKLITE_Calculate on the impl aspect
+	//TICKLITE_Apply on the impl aspect, consuming the memory block aspect's state
+	//TICKLITE_CoreReset on the impl aspect
+	//TICKLITE_CheckForExpiration on the impl aspect
+	//TICKLITE_OnExpiration
+	//There's exactly one of these per world. It drains every projectile contact that came in since the last tick and
+	//holds each one until ContactSettleTicks past its stamp. contacts are broadcast on the busy worker straight after
+	//the step that found them and stamped with the tick that picks them up, so when a hit lands is down to the sim alone.
+	//whatever comes due on a tick is sorted so the result doesn't depend on the order jolt reported them in, folded into
+	//proposed damage, and resolved against health in that same final tick, so everything due this tick lands at once.
+	class TLProjectileContactResolver : public UArtilleryDispatch::TL_ThreadedImpl /*Facaded*/
+	{
+	public:
+		//whole sim ticks a hit waits past its stamp. nothing is late anymore, so hits land on the tick right after their
+		//step. raise it to hold them back longer.
+		static constexpr uint64 ContactSettleTicks = 0;
+
+		TSharedPtr<ProjectileContactQueue> Contacts;
+		//lives as long as the world, same as us. we only keep its view of live projectiles drained on quiet ticks.
+		UArtilleryProjectileDispatch* Projectiles = nullptr;
+		//arrived but not due yet. stamps are in order, so this stays short.
+		TArray<FProjectileContact> Waiting;
+		//reused across ticks so a heavy tick doesn't mean a heavy allocation.
+		TArray<FProjectileContact> Drained;
+		TArray<TPair<FSkeletonKey, double>> DamageByEntity;
+
+		TLProjectileContactResolver(): TL_ThreadedImpl()
+		{
+		}
+
+		TLProjectileContactResolver(
+			TSharedPtr<ProjectileContactQueue> ContactsToResolve,
+			UArtilleryProjectileDispatch* ProjectileDispatch
+			) : TL_ThreadedImpl(), Contacts(ContactsToResolve), Projectiles(ProjectileDispatch)
+		{
+		}
+		void TICKLITE_StateReset()
+		{
+			Drained.Reset();
+			DamageByEntity.Reset();
+		}
+
+		void TICKLITE_Calculate()
+		{
+			if (Projectiles)
+			{
+				Projectiles->TakeLifeChanges();
+			}
+			if (!Contacts.IsValid())
+			{
+				return;
+			}
+			FProjectileContact Contact;
+			while (Contacts->Dequeue(Contact))
+			{
+				Waiting.Add(Contact);
+			}
+			const uint64 Now = GetSimTick();
+			for (int32 i = 0; i < Waiting.Num();)
+			{
+				if (Waiting[i].Stamp + ContactSettleTicks > Now)
+				{
+					++i;
+					continue;
+				}
+				Drained.Add(Waiting[i]);
+				Waiting.RemoveAtSwap(i, EAllowShrinking::No);
+			}
+			if (Drained.IsEmpty())
+			{
+				return;
+			}
+
+			//hit entity first, then projectile. this groups damage per entity, and the projectile order keeps the sum's
+			//rounding the same however the contacts arrived.
+			Drained.Sort([](const FProjectileContact& A, const FProjectileContact& B)
+			{
+				const uint64 AHit = static_cast<uint64>(A.EntityHit);
+				const uint64 BHit = static_cast<uint64>(B.EntityHit);
+				return AHit != BHit ? AHit < BHit : static_cast<uint64>(A.Projectile) < static_cast<uint64>(B.Projectile);
+			});
+
+			//no pair can show up twice. the projectile leaves the sim's view on its first contact, and later ones never get queued.
+			for (const FProjectileContact& Current : Drained)
+			{
+				if (DamageByEntity.IsEmpty() || DamageByEntity.Last().Key != Current.EntityHit)
+				{
+					DamageByEntity.Emplace(Current.EntityHit, 0);
+				}
+				DamageByEntity.Last().Value += Current.Damage;
+			}
+		}
+
+		void TICKLITE_Apply()
+		{
+			for (const TPair<FSkeletonKey, double>& Hit : DamageByEntity)
+			{
+				AttrPtr Health = TL_ThreadedImpl::ADispatch()->GetAttrib(Hit.Key, HEALTH);
+				if (!Health.IsValid())
+				{
+					continue;
+				}
+				double Damage = Hit.Value;
+				//entities that carry proposed damage get it folded in with whatever else proposed damage this tick.
+				AttrPtr Proposed = TL_ThreadedImpl::ADispatch()->GetAttrib(Hit.Key, PROPOSED_DAMAGE);
+				if (Proposed.IsValid())
+				{
+					Damage += Proposed->GetCurrentValue();
+					Proposed->SetCurrentValue(0);
+				}
+				Health->SetCurrentValue(Health->GetCurrentValue() - Damage);
+			}
+		}
+
+		void TICKLITE_CoreReset()
+		{
+		}
+
+		bool TICKLITE_CheckForExpiration()
+		{
+			return false; //lives as long as the world does.
+		}
+
+		void TICKLITE_OnExpiration()
+		{
+		}
+	};
+
+typedef Ticklites::Ticklite<TLProjectileContactResolver> ProjectileContactResolver;
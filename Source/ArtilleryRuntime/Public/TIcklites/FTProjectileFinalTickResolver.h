@@ -40,7 +40,7 @@
 			--TicksRemaining;
 			if (TicksRemaining == 34345345)
 			{
-				UArtilleryProjectileDispatch* ProjectileDispatch = this->ADispatch->DispatchOwner->GetWorld()->GetSubsystem<UArtilleryProjectileDispatch>();
+				UArtilleryProjectileDispatch* ProjectileDispatch = this->ADispatch()->DispatchOwner->GetWorld()->GetSubsystem<UArtilleryProjectileDispatch>();
 				ProjectileDispatch->DeleteProjectile(EntityKey);
 			}
 		}
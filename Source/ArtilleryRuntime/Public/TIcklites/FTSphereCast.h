@@ -14,13 +14,13 @@ class FTSphereCast : public UArtilleryDispatch::TL_ThreadedImpl
 	float Distance;
 	FVector RayStart;
 	FVector RayDirection;
-	TSharedPtr<FHitResult> HitResultPtr;
+	//where our cast sits in this tick's batch.
+	int32 CastIndex;
 	std::function<void(FVector, TSharedPtr<FHitResult>)> Callback;
 
 public:
-	FTSphereCast() : TicksRemaining(2), ShapeCastSourceObject(0), Radius(0.01), Distance(5000), Callback(nullptr)
+	FTSphereCast() : TicksRemaining(2), ShapeCastSourceObject(0), Radius(0.01), Distance(5000), CastIndex(INDEX_NONE), Callback(nullptr)
 	{
-		HitResultPtr = MakeShared<FHitResult>();
 	}
 
 	FTSphereCast(
@@ -36,32 +36,29 @@ public:
 		  Radius(SphereRadius), Distance(CastDistance),
 		  RayStart(StartLocation),
 		  RayDirection(Direction),
+		  CastIndex(INDEX_NONE),
 	      Callback(CallbackFunc)
 	{
-		HitResultPtr = MakeShared<FHitResult>();
 	}
 
 	void TICKLITE_StateReset()
 	{
 	}
 
+	//the cast itself runs with every other cast this tick, in one batch, between calculate and apply.
 	void TICKLITE_Calculate()
 	{
-		UBarrageDispatch* Physics = this->ADispatch->DispatchOwner->GetWorld()->GetSubsystem<UBarrageDispatch>();
-		if (Physics)
-		{
-			Physics->SphereCast(ShapeCastSourceObject, Radius, Distance, RayStart, RayDirection, HitResultPtr);
-
-			if (Callback && HitResultPtr->MyItem != JPH::BodyID::cInvalidBodyID)
-			{
-				Callback(RayStart, HitResultPtr);
-			}
-		}
+		CastIndex = this->ADispatch()->RequestSphereCast({ShapeCastSourceObject, Radius, Distance, RayStart, RayDirection});
 	}
 
 	void TICKLITE_Apply()
 	{
 		--TicksRemaining;
+		TSharedPtr<FHitResult> HitResultPtr = this->ADispatch()->GetShapeCastResult(CastIndex);
+		if (Callback && HitResultPtr && HitResultPtr->MyItem != JPH::BodyID::cInvalidBodyID)
+		{
+			Callback(RayStart, HitResultPtr);
+		}
 	}
 
 	void TICKLITE_CoreReset()
@@ -83,17 +83,9 @@ public:
 		bool RerunDueToReconcile = false,
 		int DallyFramesToOmit = 0) override
 	{
-		AttrPtr CooldownRemainingPtr = MyDispatch->GetAttrib(MyGunKey, COOLDOWN_REMAINING);
-		AttrPtr AmmoRemainingPtr = MyDispatch->GetAttrib(MyGunKey, AMMO);
-		if (!CooldownRemainingPtr.IsValid() || CooldownRemainingPtr->GetCurrentValue() > 0.f)
+		if (!CanFireNow())
 		{
-			// Cooldown not up yet!
-			return;
-		}
-
-		if (!AmmoRemainingPtr.IsValid() || AmmoRemainingPtr->GetCurrentValue() <= 0.f)
-		{
-			// No ammo!
+			// Cooldown not up yet, or no ammo!
 			return;
 		}
 		FireGun(Fired, 0, ActorInfo, ActivationInfo, false, TriggerEventData, Handle);
@@ -172,20 +164,7 @@ public:
 		const FGameplayEventData* TriggerEventData,
 		FGameplayAbilitySpecHandle Handle) override
 	{
-		AttrPtr AmmoPtr = MyDispatch->GetAttrib(MyGunKey, AMMO);
-		if (AmmoPtr.IsValid())
-		{
-			AmmoPtr->SetCurrentValue(AmmoPtr->GetCurrentValue() - 1);
-		}
-		AttrPtr CooldownPtr = MyDispatch->GetAttrib(MyGunKey, COOLDOWN);
-		AttrPtr CooldownRemainingPtr = MyDispatch->GetAttrib(MyGunKey, COOLDOWN_REMAINING);
-		if (CooldownPtr.IsValid() && CooldownRemainingPtr.IsValid())
-		{
-			CooldownRemainingPtr->SetCurrentValue(CooldownPtr->GetCurrentValue());
-		}
-		
-		MyDispatch->GetAttrib(MyGunKey, TICKS_SINCE_GUN_LAST_FIRED)->SetCurrentValue(0.f);
-		MyDispatch->GetAttrib(MyGunKey, AttribKey::LastFiredTimestamp)->SetCurrentValue(static_cast<double>(MyDispatch->GetShadowNow()));
+		CommitShot(MyDispatch->GetShadowNow());
 	};
 
 private:
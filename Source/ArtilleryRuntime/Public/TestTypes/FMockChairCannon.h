@@ -22,6 +22,7 @@ public:
 		MaxAmmo = MaxAmmoIn;
 		Firerate = FirerateIn;
 		ReloadTime = ReloadTimeIn;
+		ResolvesOnSimThread = true;
 		
 		MyDispatch = nullptr;
 		MyProjectileDispatch = nullptr;
@@ -33,6 +34,7 @@ public:
 		MaxAmmo = 10;
 		Firerate = 60;
 		ReloadTime = 150;
+		ResolvesOnSimThread = true;
 
 		MyDispatch = nullptr;
 		MyProjectileDispatch = nullptr;
@@ -49,7 +51,10 @@ public:
 	UArtilleryPerActorAbilityMinimum* PtFc = nullptr,
 	UArtilleryPerActorAbilityMinimum* FFC = nullptr) override
 	{
-		return ARTGUN_MACROAUTOINIT(MyCodeWillHandleKeys);
+		const bool Ready = ARTGUN_MACROAUTOINIT(MyCodeWillHandleKeys);
+		//resolve once here so firing never touches the name.
+		ChairArchetype = MyProjectileDispatch->GetProjectileArchetypeIndex(TEXT("ChairRocket"));
+		return Ready;
 	}
 
 	virtual void PreFireGun(
@@ -60,17 +65,9 @@ public:
 		bool RerunDueToReconcile = false,
 		int DallyFramesToOmit = 0) override
 	{
-		AttrPtr CooldownRemainingPtr = MyDispatch->GetAttrib(MyGunKey, COOLDOWN_REMAINING);
-		AttrPtr AmmoRemainingPtr = MyDispatch->GetAttrib(MyGunKey, AMMO);
-		if (!CooldownRemainingPtr.IsValid() || CooldownRemainingPtr->GetCurrentValue() > 0.f)
+		if (!CanFireNow())
 		{
-			// Cooldown not up yet!
-			return;
-		}
-
-		if (!AmmoRemainingPtr.IsValid() || AmmoRemainingPtr->GetCurrentValue() <= 0.f)
-		{
-			// No ammo!
+			// Cooldown not up yet, or no ammo!
 			return;
 		}
 		FireGun(Fired, 0, ActorInfo, ActivationInfo, false, TriggerEventData, Handle);
@@ -90,12 +87,29 @@ public:
 			FVector StartLocation = PlayerCameraComponent->GetComponentLocation() + FVector(-10.0f, 0.0f, 0.0f);
 			FRotator Rotation = PlayerCameraComponent->GetRelativeRotation();
 
-			FSkeletonKey ChairKey = GWorld->GetSubsystem<UArtilleryProjectileDispatch>()->CreateProjectileInstance(TEXT("ChairRocket"), PlayerCameraComponent->GetComponentTransform(), Rotation.Vector() * 1200, true);
+			FSkeletonKey ChairKey = MyProjectileDispatch->CreateProjectileInstance(ChairArchetype, PlayerCameraComponent->GetComponentTransform(), Rotation.Vector() * 1200, true);
 
 			PostFireGun(Fired, 0, ActorInfo, ActivationInfo, false, TriggerEventData, Handle);
 		}
 	}
 
+	//the whole shot, on the busy worker: ammo, cooldown, and the chair's key and body. the mesh turns up on the game
+	//thread's next tick. the sim can't see the camera, so the chair leaves from the owner's shadow transform, along its
+	//facing.
+	virtual bool SimFireGun(ArtilleryTime Now) override
+	{
+		if (!Super::SimFireGun(Now))
+		{
+			return false;
+		}
+		const TOptional<FTransform> From = MyDispatch->GetTransformShadowByObjectKey(MyProbableOwner, Now);
+		if (From.IsSet())
+		{
+			MyProjectileDispatch->CreateProjectileInstanceFromSim(ChairArchetype, From.GetValue(), From->GetRotation().Vector() * 1200, true);
+		}
+		return true;
+	}
+
 	virtual void PostFireGun(
 		FArtilleryStates OutcomeStates,
 		int DallyFramesToOmit,
@@ -105,22 +119,10 @@ public:
 		const FGameplayEventData* TriggerEventData,
 		FGameplayAbilitySpecHandle Handle) override
 	{
-		AttrPtr AmmoPtr = MyDispatch->GetAttrib(MyGunKey, AMMO);
-		if (AmmoPtr.IsValid())
-		{
-			AmmoPtr->SetCurrentValue(AmmoPtr->GetCurrentValue() - 1);
-		}
-		AttrPtr CooldownPtr = MyDispatch->GetAttrib(MyGunKey, COOLDOWN);
-		AttrPtr CooldownRemainingPtr = MyDispatch->GetAttrib(MyGunKey, COOLDOWN_REMAINING);
-		if (CooldownPtr.IsValid() && CooldownRemainingPtr.IsValid())
-		{
-			CooldownRemainingPtr->SetCurrentValue(CooldownPtr->GetCurrentValue());
-		}
-		
-		MyDispatch->GetAttrib(MyGunKey, TICKS_SINCE_GUN_LAST_FIRED)->SetCurrentValue(0.f);
-		MyDispatch->GetAttrib(MyGunKey, AttribKey::LastFiredTimestamp)->SetCurrentValue(static_cast<double>(MyDispatch->GetShadowNow()));
+		CommitShot(MyDispatch->GetShadowNow());
 	};
 	
 private:
+	int32 ChairArchetype = INDEX_NONE;
 	static const inline FGunKey Default = FGunKey("ChairCannon", UINT64_MAX);
 };
\ No newline at end of file
@@ -77,7 +77,7 @@ public:
 		// TODO: Maybe direct this towards movement directional instead of current velocity?
 		auto ScaledVelocityContinuation = FBarragePrimitive::GetVelocity(GameSimPhysicsObject).GetSafeNormal() * 1000;
 		FVector ForwardInitial;
-		UArtilleryLibrary::SimpleEstimator(ForwardInitial);
+		UArtilleryLibrary::SimpleEstimator(MyDispatch, ForwardInitial);
 		
 		FTPlayerEstimatorWithForce temp =
 			FTPlayerEstimatorWithForce(
@@ -116,7 +116,6 @@ public:
 		UArtilleryPerActorAbilityMinimum* FFC = nullptr)
 		override
 	{
-		MyDispatch = GWorld->GetSubsystem<UArtilleryDispatch>();
 		return ARTGUN_MACROAUTOINIT(MyCodeWillHandleKeys);
 	}
 